@@ -0,0 +1,110 @@
+#include "basic_schedulers.h"
+
+#include <utility>
+
+namespace
+{
+    // Storage for a priority queue, reserved up front so pushing never has to reallocate
+    std::vector<int> reserved_storage( const ProgramTable& programs )
+    {
+        std::vector<int> storage;
+        storage.reserve( programs.size() );
+        return storage;
+    }
+}
+
+/* Constructor for the RRScheduler class
+*/
+RRScheduler::RRScheduler( const SchedulerSettings& settings ) : Scheduler( settings )
+{
+}
+
+void RRScheduler::push( const int programIndex )
+{
+    queue_.push( programIndex );
+}
+
+int RRScheduler::pop()
+{
+    int nextProgram = queue_.front();
+    queue_.pop();
+    return nextProgram;
+}
+
+bool RRScheduler::empty() const
+{
+    return queue_.empty();
+}
+
+/* Constructor for the FIFOScheduler class
+* The comparator reads the programs out of the PCB table
+*/
+FIFOScheduler::FIFOScheduler( const SchedulerSettings& settings ) 
+    : Scheduler( settings ), queue_( Comparator( programs_ ), reserved_storage( programs_ ) )
+{
+}
+
+void FIFOScheduler::push( const int programIndex )
+{
+    queue_.push( programIndex );
+}
+
+int FIFOScheduler::pop()
+{
+    int nextProgram = queue_.top();
+    queue_.pop();
+    return nextProgram;
+}
+
+bool FIFOScheduler::empty() const
+{
+    return queue_.empty();
+}
+
+/* Constructor for the SRTFScheduler class
+* The heap is reserved up front, so pushing never has to reallocate
+*/
+SRTFScheduler::SRTFScheduler( const SchedulerSettings& settings ) : Scheduler( settings )
+{
+    queue_.reserve( programs_.size() );
+}
+
+/* Queue a program, keyed by the time it has left. That can't change while it is queued
+*/
+void SRTFScheduler::push( const int programIndex )
+{
+    Key key = { programs_[programIndex].remaining_time(), sequence_++ };
+    queue_.push( programIndex, key );
+}
+
+int SRTFScheduler::pop()
+{
+    return queue_.pop();
+}
+
+bool SRTFScheduler::empty() const
+{
+    return queue_.empty();
+}
+
+/* SRTF needs to assign IDs dynamically to keep them relative to starting time
+*/
+bool SRTFScheduler::numbers_on_first_run() const
+{
+    return true;
+}
+
+/* SRTF compares every program that becomes ready against the running one
+*/
+bool SRTFScheduler::preemptive() const
+{
+    return true;
+}
+
+/* Preempt if the shortest queued program needs less time than the running one
+* @param runningTime = usec the running program still needs
+*/
+bool SRTFScheduler::preempts( const int runningProgram, const long long runningTime ) const
+{
+    return !queue_.empty() && queue_.top_key().remainingTime < runningTime;
+}
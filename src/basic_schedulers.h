@@ -0,0 +1,83 @@
+/*
+* Filename: basic_schedulers.h
+* Specifications for the original scheduling policies: FIFO-P, RR and SRTF-P.
+*/
+
+#ifndef BASIC_SCHEDULERS_H
+#define BASIC_SCHEDULERS_H
+
+#include <queue>
+#include <vector>
+
+#include "indexed_heap.h"
+#include "scheduler.h"
+
+/* Round Robin, programs take turns in the order they became ready */
+class RRScheduler final : public Scheduler
+{
+public:
+    explicit RRScheduler( const SchedulerSettings& settings );
+
+    void push( const int programIndex ) override;
+    int pop() override;
+    bool empty() const override;
+
+private:
+    std::queue<int> queue_;
+};
+
+/* First In First Out - Preemptive, the program that arrived first runs first */
+class FIFOScheduler final : public Scheduler
+{
+public:
+    explicit FIFOScheduler( const SchedulerSettings& settings );
+
+    void push( const int programIndex ) override;
+    int pop() override;
+    bool empty() const override;
+
+private:
+    struct Comparator{
+        explicit Comparator( const ProgramTable &programs ) : programs_( &programs ) {}
+        bool operator()( const int left, const int right ) const {
+            return (*programs_)[left].id > (*programs_)[right].id;
+        }
+        const ProgramTable* programs_;
+    };
+    std::priority_queue<int, std::vector<int>, Comparator> queue_;
+};
+
+/* Shortest Remaining Time First - Preemptive. A program that becomes ready with less time
+* left than the running one takes over the CPU right away. Programs are numbered as they
+* first run */
+class SRTFScheduler final : public Scheduler
+{
+public:
+    explicit SRTFScheduler( const SchedulerSettings& settings );
+
+    void push( const int programIndex ) override;
+    int pop() override;
+    bool empty() const override;
+    bool numbers_on_first_run() const override;
+    bool preemptive() const override;
+    bool preempts( const int runningProgram, const long long runningTime ) const override;
+
+private:
+    struct Key
+    {
+        long long remainingTime;
+        unsigned long long sequence; // programs with equal times run in the order they were queued
+        bool operator<( const Key& other ) const
+        {
+            if( remainingTime != other.remainingTime )
+            {
+                return remainingTime < other.remainingTime;
+            }
+            return sequence < other.sequence;
+        }
+    };
+    IndexedHeap<Key> queue_; // by index in programs_
+    unsigned long long sequence_ = 0;
+};
+
+#endif // BASIC_SCHEDULERS_H
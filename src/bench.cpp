@@ -0,0 +1,528 @@
+/* Benchmark
+*
+* Filename: bench.cpp
+*
+* Description: Microbenchmarks of the simulator's hot paths: parsing meta-data, the ready
+* queues of the basic scheduling policies, walking a program's operations, whole
+* virtual-time runs, and context switches in the core loop compiled for a policy against
+* the generic loop that calls the ready queue virtually. Workloads are generated with a fixed seed, so every run measures
+* the same work. Results are written as CSV, every value is a rate, higher is better.
+* Given the CSV of an earlier run as a baseline, every result is compared to it and the
+* exit status is non-zero if any of them got slower by more than the threshold.
+*
+* Compilation: Use the provided makefile, which also runs it.
+*   $ make bench
+*
+* Usage: Output goes to stdout. --quick leaves out the largest sizes.
+*   $ ./benchmark [--quick] [--baseline results.csv] [--threshold percent]
+*/
+
+/* Dependencies */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "basic_schedulers.h"
+#include "meta_data_reader.h"
+#include "operation.h"
+#include "program.h"
+#include "program_table.h"
+#include "scheduler.h"
+#include "simulator.h"
+#include "workload.h"
+
+namespace
+{
+    const int REPETITIONS = 5; // every result is the best of these
+    const char* const POLICIES[] = { "RR", "FIFO-P", "SRTF-P" };
+    const char* const META_DATA_PATH = "benchmark.mdf";
+
+    /* Single result, compared with the baseline by benchmark and size */
+    struct Result
+    {
+        std::string benchmark;
+        long long size;
+        double value;
+        std::string unit;
+    };
+
+    /* Host seconds of the fastest of a few runs
+    * @param run = work to time, called once per repetition
+    */
+    template<class Function>
+    double best_of( Function run )
+    {
+        double best = 0;
+        for( int i = 0; i < REPETITIONS; i++ )
+        {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+            best = i == 0 ? seconds : std::min( best, seconds );
+        }
+        return std::max( best, 1e-9 );
+    }
+
+    /* Ready queue that hides the class of a built-in policy from the simulator, which then
+    * runs the generic core loop it has for policies added to the registry. Every call the
+    * loop makes to the queue is virtual again, as they all were before the loop was compiled
+    * per policy. The calls on to the policy itself are direct, its class is final
+    */
+    template<class Policy>
+    class VirtualQueue final : public Scheduler
+    {
+    public:
+        explicit VirtualQueue( const SchedulerSettings& settings ) : Scheduler( settings ), policy_( settings ) {}
+
+        void push( const int programIndex ) override { policy_.push( programIndex ); }
+        int pop() override { return policy_.pop(); }
+        bool empty() const override { return policy_.empty(); }
+        int quantum( const int programIndex ) const override { return policy_.quantum( programIndex ); }
+        void ran( const int programIndex, const long long time ) override { policy_.ran( programIndex, time ); }
+        void update( const std::chrono::nanoseconds now ) override { policy_.update( now ); }
+        bool numbers_on_first_run() const override { return policy_.numbers_on_first_run(); }
+        bool preemptive() const override { return policy_.preemptive(); }
+        bool preempts( const int runningProgram, const long long runningTime ) const override
+        {
+            return policy_.preempts( runningProgram, runningTime );
+        }
+
+    private:
+        Policy policy_;
+    };
+
+    // Scheduling code of a built-in policy behind a VirtualQueue
+    std::string virtual_code( const std::string& code )
+    {
+        return code + "/virtual";
+    }
+
+    /* Make the policies of POLICIES available behind a VirtualQueue as well
+    */
+    void add_virtual_queues()
+    {
+        SchedulerRegistry::add( virtual_code( "RR" ), []( const SchedulerSettings& settings ){
+            return new VirtualQueue<RRScheduler>( settings );
+        });
+        SchedulerRegistry::add( virtual_code( "FIFO-P" ), []( const SchedulerSettings& settings ){
+            return new VirtualQueue<FIFOScheduler>( settings );
+        });
+        SchedulerRegistry::add( virtual_code( "SRTF-P" ), []( const SchedulerSettings& settings ){
+            return new VirtualQueue<SRTFScheduler>( settings );
+        });
+    }
+
+    /* Write a meta-data file of random programs, a mix of processing and I/O of every device
+    * @param filePath = file to write
+    * @param programs = number of programs
+    * @return size of the file in bytes
+    */
+    long long write_meta_data( const std::string& filePath, const int programs )
+    {
+        static const char* const IO[] = { "I(hard drive)", "O(hard drive)", "I(keyboard)", "O(monitor)", "O(printer)" };
+        std::mt19937 random( 3 );
+        std::uniform_int_distribution<int> operations( 5, 30 );
+        std::uniform_int_distribution<int> cycles( 1, 15 );
+        std::uniform_int_distribution<int> kind( 0, 9 );
+
+        std::ofstream fout( filePath );
+        fout << "Start Program Meta-Data Code:\nS(start)0; ";
+        for( int program = 0; program < programs; program++ )
+        {
+            fout << "A(start)0; ";
+            const int count = operations( random );
+            for( int operation = 0; operation < count; operation++ )
+            {
+                const int which = kind( random );
+                fout << ( which < 5 ? "P(run)" : IO[which - 5] ) << cycles( random ) << "; ";
+            }
+            fout << "A(end)0;\n";
+        }
+        fout << "S(end)0.\nEnd Program Meta-Data Code.\n";
+        if( !fout )
+        {
+            throw std::runtime_error( "Error: Unable to write file " + filePath + "\n" );
+        }
+        return static_cast<long long>( fout.tellp() );
+    }
+
+    /* Parse a whole meta-data file, the way the simulator reads it at the start of a run
+    * @param programs = number of programs in the generated file
+    */
+    Result parse_benchmark( const int programs )
+    {
+        const long long bytes = write_meta_data( META_DATA_PATH, programs );
+        std::vector<Operation> operations;
+        ProgramAttributes attributes;
+        long long read = 0;
+
+        // small files are read several times, so the time isn't mostly noise
+        const int rounds = static_cast<int>( std::max( 1LL, 50000000 / bytes ) );
+        const double seconds = best_of( [&](){
+            for( int round = 0; round < rounds; round++ )
+            {
+                MetaDataReader reader( META_DATA_PATH );
+                while( reader.next_program( operations, attributes ) )
+                {
+                    read += static_cast<long long>( operations.size() );
+                }
+            }
+        });
+        std::remove( META_DATA_PATH );
+        if( read == 0 )
+        {
+            throw std::runtime_error( "Error: Benchmark meta-data has no programs\n" );
+        }
+        return Result{ "parse", programs, static_cast<double>( bytes ) * rounds / seconds / 1e6, "MB/s" };
+    }
+
+    /* Push every program into a ready queue, pop and push each one again, as programs
+    * take turns, then drain the queue
+    * @param code = scheduling code of the policy
+    * @param programs = number of queued programs
+    */
+    Result queue_benchmark( const std::string& code, const int programs )
+    {
+        Operation operation;
+        operation.cycles = 1;
+        operation.type = 'P';
+        operation.opcode = OP_RUN;
+        operation.device = NO_DEVICE;
+
+        CycleTimes cycleTimes;
+        ProgramTable table;
+        std::mt19937 random( 7 );
+        std::uniform_int_distribution<long long> remaining( 1, 1000000 );
+        for( int i = 0; i < programs; i++ )
+        {
+            table.push_back( Program( &operation, 1, remaining( random ), &cycleTimes ) );
+            table[i].id = i + 1;
+        }
+        std::vector<int> order( programs );
+        for( int i = 0; i < programs; i++ )
+        {
+            order[i] = i;
+        }
+        std::shuffle( order.begin(), order.end(), random );
+
+        SchedulerSettings settings;
+        settings.programs = &table;
+        settings.quantum = 3;
+        settings.processorCycleTime = 10000;
+        long long checksum = 0;
+        const int rounds = std::max( 1, 1000000 / programs );
+        const double seconds = best_of( [&](){
+            for( int round = 0; round < rounds; round++ )
+            {
+                std::unique_ptr<Scheduler> queue = SchedulerRegistry::create( code, settings );
+                for( const int programIndex : order )
+                {
+                    queue->push( programIndex );
+                }
+                for( int i = 0; i < programs; i++ )
+                {
+                    const int programIndex = queue->pop();
+                    queue->ran( programIndex, 1 );
+                    queue->push( programIndex );
+                }
+                while( !queue->empty() )
+                {
+                    checksum += queue->pop();
+                }
+            }
+        });
+        if( checksum != static_cast<long long>( programs ) * ( programs - 1 ) / 2 * rounds * REPETITIONS )
+        {
+            throw std::runtime_error( "Error: Ready queue " + code + " lost programs\n" );
+        }
+        return Result{ "queue/" + code, programs, 4.0 * programs * rounds / seconds / 1e6, "Mops/s" };
+    }
+
+    /* Walk a program's operations, every one is handed back once as if it were interrupted
+    * @param operationCount = operations of the program
+    */
+    Result program_benchmark( const int operationCount )
+    {
+        CycleTimes cycleTimes;
+        cycleTimes.processor = 10000;
+        std::vector<Operation> operations( operationCount );
+        long long total = 0;
+        for( int i = 0; i < operationCount; i++ )
+        {
+            Operation &operation = operations[i];
+            operation.cycles = 1 + i % 15;
+            operation.type = 'P';
+            operation.opcode = OP_RUN;
+            operation.device = NO_DEVICE;
+            total += cycleTimes.duration( operation );
+        }
+
+        Program program( operations.data(), operations.size(), total, &cycleTimes );
+        const int walks = std::max( 1, 10000000 / operationCount );
+        long long checksum = 0;
+        const double seconds = best_of( [&](){
+            for( int walk = 0; walk < walks; walk++ )
+            {
+                program.restart();
+                while( !program.done() )
+                {
+                    Operation operation = program.next();
+                    operation.run( 1, cycleTimes.cycle_time( operation ) );
+                    program.return_operation( operation );
+                    checksum += program.next().cycles;
+                }
+            }
+        });
+        if( checksum == 0 )
+        {
+            throw std::runtime_error( "Error: Program has no operations\n" );
+        }
+        return Result{ "program/next", operationCount, 2.0 * walks * operationCount / seconds / 1e6, "Mops/s" };
+    }
+
+    /* Time a run of a generated workload in virtual time without a log
+    * @param workload = programs to run, shared by every run
+    * @param code = scheduling code of the policy
+    * @param cpus = number of simulated CPUs
+    * @param dispatches = receives the number of times a CPU switched to a program
+    * @return host seconds of the fastest run
+    */
+    double time_run( const std::shared_ptr<const Workload>& workload, const std::string& code,
+        const int cpus, unsigned long long& dispatches )
+    {
+        const std::string config =
+            "Start Simulator Configuration File\n"
+            "Version/Phase: 3.0\n"
+            "File Path: " + std::string( META_DATA_PATH ) + "\n"
+            "CPU Scheduling Code: " + code + "\n"
+            "Quantum Time (cycles): 3\n"
+            "Processor cycle time (msec): 10\n"
+            "Monitor display time (msec): 20\n"
+            "Hard drive cycle time (msec): 15\n"
+            "Printer cycle time (msec): 25\n"
+            "Keyboard cycle time (msec): 50\n"
+            "Log: Log to None\n"
+            "Log File Path: benchmark.lgf\n"
+            "Simulation Clock: Virtual\n"
+            "CPU Count: " + std::to_string( cpus ) + "\n"
+            "End Simulator Configuration File\n";
+
+        return best_of( [&](){
+            std::istringstream fin( config );
+            Simulator simulator( fin, workload );
+            simulator.run();
+            dispatches = simulator.summary().dispatches;
+        });
+    }
+
+    /* Run a generated workload in virtual time without a log
+    * @param workload = programs to run, shared by every run
+    * @param programs = number of programs in the workload, names the result
+    * @param code = scheduling code of the policy
+    * @param cpus = number of simulated CPUs
+    */
+    Result run_benchmark( const std::shared_ptr<const Workload>& workload, const int programs,
+        const std::string& code, const int cpus )
+    {
+        unsigned long long dispatches = 0;
+        const double seconds = time_run( workload, code, cpus, dispatches );
+        return Result{ "run/" + code + "/cpu" + std::to_string( cpus ), programs,
+            dispatches / seconds / 1e3, "kdispatches/s" };
+    }
+
+    /* Context switches of a single CPU, in the core loop compiled for the policy and in
+    * the generic loop that calls the ready queue through its virtual interface. Both make
+    * the same switches, so the two rates compare what a switch costs in either loop
+    * @param workload = programs to run, shared by every run
+    * @param programs = number of programs in the workload, names the results
+    * @param code = scheduling code of one of POLICIES
+    * @return result of the compiled loop, then of the generic one
+    */
+    std::vector<Result> switch_benchmark( const std::shared_ptr<const Workload>& workload,
+        const int programs, const std::string& code )
+    {
+        unsigned long long compiledSwitches = 0;
+        unsigned long long virtualSwitches = 0;
+        const double compiled = time_run( workload, code, 1, compiledSwitches );
+        const double generic = time_run( workload, virtual_code( code ), 1, virtualSwitches );
+        if( compiledSwitches != virtualSwitches )
+        {
+            throw std::runtime_error( "Error: Core loops of " + code + " made different context switches\n" );
+        }
+        return std::vector<Result>{
+            Result{ "switch/" + code + "/compiled", programs, compiledSwitches / compiled / 1e3, "kswitches/s" },
+            Result{ "switch/" + code + "/virtual", programs, virtualSwitches / generic / 1e3, "kswitches/s" } };
+    }
+
+    /* Read the results of an earlier run, by benchmark and size
+    * @param filePath = CSV written by this program
+    */
+    std::map<std::pair<std::string, long long>, double> read_baseline( const std::string& filePath )
+    {
+        std::ifstream fin( filePath );
+        if( !fin )
+        {
+            throw std::runtime_error( "Error: Unable to open file " + filePath + "\n" );
+        }
+        std::map<std::pair<std::string, long long>, double> baseline;
+        std::string line;
+        std::getline( fin, line ); // header
+        while( std::getline( fin, line ) )
+        {
+            std::istringstream fields( line );
+            std::string benchmark, size, value;
+            if( std::getline( fields, benchmark, ',' ) && std::getline( fields, size, ',' ) &&
+                std::getline( fields, value, ',' ) )
+            {
+                baseline[std::make_pair( benchmark, std::atoll( size.c_str() ) )] = std::atof( value.c_str() );
+            }
+        }
+        return baseline;
+    }
+}
+
+/* Main */
+int main(const int argc, char const *argv[])
+{
+    bool quick = false;
+    std::string baselinePath;
+    double threshold = 10;
+    for( int i = 1; i < argc; i++ )
+    {
+        const std::string argument = argv[i];
+        if( argument == "--quick" )
+        {
+            quick = true;
+        }
+        else if( argument == "--baseline" && i + 1 < argc )
+        {
+            baselinePath = argv[++i];
+        }
+        else if( argument == "--threshold" && i + 1 < argc )
+        {
+            threshold = std::atof( argv[++i] );
+        }
+        else
+        {
+            std::cerr
+            << "Error: Incorrect command line arguments" << std::endl
+            << "Example usage: " << argv[0] << " [--quick] [--baseline results.csv] [--threshold percent]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    int regressions = 0;
+    try
+    {
+        std::map<std::pair<std::string, long long>, double> baseline;
+        if( !baselinePath.empty() )
+        {
+            baseline = read_baseline( baselinePath );
+        }
+
+        std::cout << "benchmark,size,value,unit";
+        if( !baselinePath.empty() )
+        {
+            std::cout << ",baseline,change_percent,status";
+        }
+        std::cout << std::endl;
+
+        // each result is written as soon as it is known, long runs show progress
+        auto report = [&]( const Result& result ){
+            char buffer[256];
+            std::snprintf( buffer, sizeof(buffer), "%s,%lld,%.3f,%s", result.benchmark.c_str(),
+                result.size, result.value, result.unit.c_str() );
+            std::cout << buffer;
+            if( !baselinePath.empty() )
+            {
+                const auto previous = baseline.find( std::make_pair( result.benchmark, result.size ) );
+                if( previous == baseline.end() || previous->second <= 0 )
+                {
+                    std::cout << ",,,new";
+                }
+                else
+                {
+                    const double change = ( result.value / previous->second - 1 ) * 100;
+                    const bool regressed = change < -threshold;
+                    regressions += regressed ? 1 : 0;
+                    std::snprintf( buffer, sizeof(buffer), ",%.3f,%+.1f,%s", previous->second, change,
+                        regressed ? "regression" : "ok" );
+                    std::cout << buffer;
+                }
+            }
+            std::cout << std::endl;
+        };
+
+        report( parse_benchmark( quick ? 20000 : 100000 ) );
+
+        const int largestQueue = quick ? 100000 : 1000000;
+        for( const char* code : POLICIES )
+        {
+            for( int programs = 1000; programs <= largestQueue; programs *= 10 )
+            {
+                report( queue_benchmark( code, programs ) );
+            }
+        }
+
+        for( const int operations : { 16, 1024 } )
+        {
+            report( program_benchmark( operations ) );
+        }
+
+        const int programs = quick ? 500 : 2000;
+        write_meta_data( META_DATA_PATH, programs );
+        std::shared_ptr<const Workload> workload;
+        try
+        {
+            workload = std::make_shared<const Workload>( META_DATA_PATH );
+        }
+        catch( ... )
+        {
+            std::remove( META_DATA_PATH );
+            throw;
+        }
+        std::remove( META_DATA_PATH );
+        for( const char* code : POLICIES )
+        {
+            for( const int cpus : { 1, 4 } )
+            {
+                report( run_benchmark( workload, programs, code, cpus ) );
+            }
+        }
+
+        add_virtual_queues();
+        for( const char* code : POLICIES )
+        {
+            for( const Result& result : switch_benchmark( workload, programs, code ) )
+            {
+                report( result );
+            }
+        }
+    }
+
+    catch( const std::exception& e )
+    {
+        std::cerr << e.what() << "Exiting program due to error" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if( regressions > 0 )
+    {
+        std::cerr << regressions << " benchmark" << ( regressions == 1 ? "" : "s" )
+            << " regressed by more than " << threshold << "%" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
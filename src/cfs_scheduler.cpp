@@ -0,0 +1,128 @@
+#include "cfs_scheduler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    const char* const LATENCY_SETTING = "CFS Target Latency (msec)";
+    const char* const GRANULARITY_SETTING = "CFS Minimum Granularity (msec)";
+
+    // Target latency is this many minimum granularities by default
+    const int DEFAULT_LATENCY_GRANULARITIES = 8;
+
+    // Weights of nice -20 to 19, each step is about 10% more or less CPU time
+    const int NICE_WEIGHTS[40] = {
+        88761, 71755, 56483, 46273, 36291,
+        29154, 23254, 18705, 14949, 11916,
+        9548,  7620,  6100,  4904,  3906,
+        3121,  2501,  1991,  1586,  1277,
+        1024,  820,   655,   526,   423,
+        335,   272,   215,   172,   137,
+        110,   87,    70,    56,    45,
+        36,    29,    23,    18,    15
+    };
+    const int NICE_0_WEIGHT = 1024;
+}
+
+/* Constructor for the CFSScheduler class
+* Without settings programs run at least a processor cycle, and every ready program
+* gets to run within 8 processor cycles
+* @param settings = PCB table, config values and the CFS settings
+* @except Throws exception if the CFS settings are invalid
+*/
+CFSScheduler::CFSScheduler( const SchedulerSettings& settings ) : Scheduler( settings )
+{
+    const auto &options = settings.options;
+    auto latency = options.find( LATENCY_SETTING );
+    auto granularity = options.find( GRANULARITY_SETTING );
+
+    // the settings are in msec
+    minGranularity_ = std::max( 1, settings.processorCycleTime );
+    if( granularity != options.end() )
+    {
+        minGranularity_ = 1000LL * positive_setting( granularity->second, 
+            "Error: CFS minimum granularity must be positive\n" );
+    }
+    targetLatency_ = minGranularity_ * DEFAULT_LATENCY_GRANULARITIES;
+    if( latency != options.end() )
+    {
+        targetLatency_ = 1000LL * positive_setting( latency->second,
+            "Error: CFS target latency must be positive\n" );
+    }
+    if( targetLatency_ < minGranularity_ )
+    {
+        throw std::runtime_error( "Error: CFS target latency can't be below the minimum granularity\n" );
+    }
+}
+
+/* Optional config settings
+*/
+std::vector<std::string> CFSScheduler::setting_names()
+{
+    return { LATENCY_SETTING, GRANULARITY_SETTING };
+}
+
+/* Weight lookup
+* @param nice = nice value, -20 to 19
+*/
+int CFSScheduler::weight( const int nice )
+{
+    return NICE_WEIGHTS[ std::min( 19, std::max( -20, nice ) ) + 20 ];
+}
+
+/* Insert a program into the tree. A program that was blocked or just arrived starts no
+* further back than half a target latency behind the queued programs, so it runs soon
+* but can't make up for all the time it wasn't ready
+*/
+void CFSScheduler::push( const int programIndex )
+{
+    Program &program = programs_[programIndex];
+    long long &vruntime = program.scheduling.vruntime;
+    vruntime = std::max( vruntime, minVruntime_ - targetLatency_ / 2 );
+
+    Entry entry = { vruntime, sequence_++, programIndex };
+    tree_.insert( entry );
+    queuedWeight_ += weight( program.attributes.nice );
+}
+
+/* Take the program with the least virtual runtime
+*/
+int CFSScheduler::pop()
+{
+    auto first = tree_.begin();
+    int nextProgram = first->programIndex;
+    minVruntime_ = std::max( minVruntime_, first->vruntime );
+    tree_.erase( first );
+    queuedWeight_ -= weight( programs_[nextProgram].attributes.nice );
+    return nextProgram;
+}
+
+bool CFSScheduler::empty() const
+{
+    return tree_.empty();
+}
+
+/* The program's share of the target latency, by its weight among the ready programs,
+* but no less than the minimum granularity. Called right after pop(), so the program
+* itself is not queued anymore
+* @return the slice in processor cycles, rounded up
+*/
+int CFSScheduler::quantum( const int programIndex ) const
+{
+    const long long programWeight = weight( programs_[programIndex].attributes.nice );
+    const long long slice = std::max<long long>( minGranularity_, 
+        targetLatency_ * programWeight / ( queuedWeight_ + programWeight ) );
+    const long long cycleTime = std::max( 1, settings_.processorCycleTime );
+    return static_cast<int>( ( slice + cycleTime - 1 ) / cycleTime );
+}
+
+/* Charge the program for the time it ran, scaled by its weight
+* @param programIndex = program that ran
+* @param time = usec it ran
+*/
+void CFSScheduler::ran( const int programIndex, const long long time )
+{
+    Program &program = programs_[programIndex];
+    program.scheduling.vruntime += time * NICE_0_WEIGHT / weight( program.attributes.nice );
+}
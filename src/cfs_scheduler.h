@@ -0,0 +1,65 @@
+/*
+* Filename: cfs_scheduler.h
+* Specifications for the Completely Fair Scheduler policy.
+*/
+
+#ifndef CFS_SCHEDULER_H
+#define CFS_SCHEDULER_H
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "scheduler.h"
+
+/* Completely Fair Scheduler. Every program accumulates virtual runtime, the time it ran
+* scaled down by its weight, and the program with the least virtual runtime runs next.
+* Weights come from the programs' nice values, so each program gets a share of the CPU
+* in proportion to its weight. Ready programs are kept in a balanced tree ordered by
+* virtual runtime, which makes every operation O(log n) */
+class CFSScheduler final : public Scheduler
+{
+public:
+    explicit CFSScheduler( const SchedulerSettings& settings );
+
+    // Names of the optional config settings this policy reads
+    static std::vector<std::string> setting_names();
+
+    // Weight of a nice value, a nice 0 program weighs 1024
+    static int weight( const int nice );
+
+    void push( const int programIndex ) override;
+    int pop() override;
+    bool empty() const override;
+    int quantum( const int programIndex ) const override;
+    void ran( const int programIndex, const long long time ) override;
+
+private:
+    struct Entry
+    {
+        long long vruntime;
+        unsigned long long sequence; // programs with equal vruntime run in the order they were queued
+        int programIndex;
+        bool operator<( const Entry& other ) const
+        {
+            if( vruntime != other.vruntime )
+            {
+                return vruntime < other.vruntime;
+            }
+            return sequence < other.sequence;
+        }
+    };
+    std::set<Entry> tree_;
+    unsigned long long sequence_ = 0;
+
+    // Never decreases, keeps programs that slept from claiming the CPU for too long
+    long long minVruntime_ = 0;
+
+    // Sum of the weights of the queued programs
+    long long queuedWeight_ = 0;
+
+    long long targetLatency_; // usec in which every ready program should get to run once
+    long long minGranularity_; // usec a program runs at least
+};
+
+#endif // CFS_SCHEDULER_H
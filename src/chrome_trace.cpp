@@ -0,0 +1,236 @@
+#include "chrome_trace.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+    // Trace processes, which group the tracks. Every device has one of its own, numbered
+    // from DEVICE_PROCESS on in the order of the devices, so it can have any number of tracks
+    const int CPU_PROCESS = 1;
+    const int DEVICE_PROCESS = 2;
+
+    int device_process( const Device device )
+    {
+        return DEVICE_PROCESS + device - HARD_DRIVE;
+    }
+
+    std::string process_name( const int processID )
+    {
+        return "Process " + std::to_string( processID );
+    }
+}
+
+/* Open the document and name the track groups
+* @param out = buffer the header is appended to
+*/
+void ChromeTraceWriter::header( std::string& out )
+{
+    out += "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    event( out, 'M', "process_name", CPU_PROCESS, 0, 0, "\"name\": \"CPUs\"" );
+}
+
+/* Turn a record into trace events. A process holds a CPU from the moment it starts
+* processing until it stops, is preempted or the OS selects again
+* @param record to encode
+* @param out = buffer the events are appended to
+*/
+void ChromeTraceWriter::encode( const LogRecord& record, std::string& out )
+{
+    // with a single CPU records aren't numbered, with several 0 is the simulator itself
+    const int cpu = record.cpu == 0 ? 1 : record.cpu;
+    const long long time = record.time;
+    lastTime_ = std::max( lastTime_, time );
+    const bool system = record.event == SIMULATOR_START || record.event == SIMULATOR_END ||
+        record.event == OS_PREPARING;
+    if( !system )
+    {
+        name_track( out, CPU_PROCESS, cpu, "CPU " + std::to_string( cpu ) );
+    }
+
+    const std::string process = process_name( record.processID );
+    switch( record.event )
+    {
+    case SIMULATOR_START:
+    case SIMULATOR_END:
+    case OS_PREPARING:
+    {
+        const char* names[] = { "Simulator start", "Simulator end", "Preparing processes" };
+        event( out, 'i', names[ record.event - SIMULATOR_START ], CPU_PROCESS, 0, time );
+        if( record.event == SIMULATOR_END )
+        {
+            for( std::size_t track = 0; track < running_.size(); track++ )
+            {
+                stop_running( out, static_cast<int>( track ), time );
+            }
+        }
+        break;
+    }
+    case OS_SELECTING:
+    case OS_IDLE:
+    case PROCESS_RUN_END:
+    case PROCESS_REMOVE:
+        stop_running( out, cpu, time );
+        break;
+    case PROCESS_START:
+    case PROCESS_IO:
+        break;
+    case PROCESS_RUN:
+        stop_running( out, cpu, time );
+        if( running_.size() <= static_cast<std::size_t>( cpu ) )
+        {
+            running_.resize( cpu + 1, 0 );
+        }
+        running_[cpu] = record.processID;
+        event( out, 'B', process, CPU_PROCESS, cpu, time );
+        break;
+    case QUANTUM_EXPIRED:
+        stop_running( out, cpu, time );
+        event( out, 'i', "Quantum expired", CPU_PROCESS, cpu, time );
+        break;
+    case PROCESS_PREEMPTED:
+        stop_running( out, cpu, time );
+        event( out, 'i', process + " preempted", CPU_PROCESS, cpu, time );
+        break;
+    case PROCESS_ARRIVE:
+        event( out, 'i', "Process arrived", CPU_PROCESS, cpu, time );
+        break;
+    case DEADLINE_MISSED:
+        event( out, 'i', process + " missed its deadline", CPU_PROCESS, cpu, time,
+            "\"tardiness_ms\": " + std::to_string( record.value ) );
+        break;
+    case IO_START:
+    case IO_END:
+    {
+        // an operation takes the first free track of its device and keeps it until it ends
+        if( lanes_.empty() )
+        {
+            lanes_.resize( DEVICE_COUNT );
+        }
+        Lanes &lanes = lanes_[record.device];
+        const int pid = device_process( record.device );
+        const std::string operation = process + ( record.input ? " input" : " output" );
+        if( record.event == IO_START )
+        {
+            int lane = lanes.count;
+            if( !lanes.free.empty() )
+            {
+                lane = *lanes.free.begin();
+                lanes.free.erase( lanes.free.begin() );
+            }
+            else
+            {
+                lanes.count++;
+            }
+            lanes.busy[record.processID] = lane;
+            name_device( out, record.device );
+            name_track( out, pid, lane, std::string( device_name( record.device ) ) +
+                ( lane == 0 ? "" : " #" + std::to_string( lane + 1 ) ) );
+            event( out, 'B', operation, pid, lane, time );
+        }
+        else
+        {
+            const auto busy = lanes.busy.find( record.processID );
+            if( busy != lanes.busy.end() )
+            {
+                event( out, 'E', operation, pid, busy->second, time );
+                lanes.free.insert( busy->second );
+                lanes.busy.erase( busy );
+            }
+            event( out, 'i', "I/O interrupt: " + process, CPU_PROCESS, cpu, time );
+        }
+        break;
+    }
+    case EVENT_COUNT:
+        break;
+    }
+}
+
+/* End the document, slices that are still open end at the last record
+* @param out = buffer the footer is appended to
+*/
+void ChromeTraceWriter::footer( std::string& out )
+{
+    for( std::size_t track = 0; track < running_.size(); track++ )
+    {
+        stop_running( out, static_cast<int>( track ), lastTime_ );
+    }
+    for( std::size_t device = 0; device < lanes_.size(); device++ )
+    {
+        for( const std::pair<const int, int> &busy : lanes_[device].busy )
+        {
+            event( out, 'E', "", device_process( static_cast<Device>( device ) ), busy.second, lastTime_ );
+        }
+        lanes_[device].busy.clear();
+    }
+    out += "\n]}\n";
+}
+
+/* Append one event
+* @param phase = B, E, i or M, as in the Trace Event Format
+* @param name = shown on the event, names have no characters that need escaping
+* @param pid, tid = track of the event, tid 0 of the CPUs for simulation-wide instants
+* @param time = microseconds since the simulation started
+* @param args = JSON members of the event's arguments
+*/
+void ChromeTraceWriter::event( std::string& out, const char phase, const std::string& name, const int pid,
+    const int tid, const long long time, const std::string& args )
+{
+    out += first_ ? "\n" : ",\n";
+    first_ = false;
+    out.append( "{\"ph\": \"" ).append( 1, phase ).append( "\", \"name\": \"" ).append( name )
+        .append( "\", \"pid\": " ).append( std::to_string( pid ) )
+        .append( ", \"tid\": " ).append( std::to_string( tid ) )
+        .append( ", \"ts\": " ).append( std::to_string( time ) );
+    if( phase == 'i' )
+    {
+        // track 0 is no CPU, its instants are events of the whole simulation
+        out += tid == 0 ? ", \"s\": \"g\"" : ", \"s\": \"t\"";
+    }
+    if( !args.empty() )
+    {
+        out.append( ", \"args\": {" ).append( args ).append( "}" );
+    }
+    out += "}";
+}
+
+/* Emit a track's name, once
+*/
+void ChromeTraceWriter::name_track( std::string& out, const int pid, const int tid, const std::string& name )
+{
+    if( !namedTracks_.insert( std::make_pair( pid, tid ) ).second )
+    {
+        return;
+    }
+    event( out, 'M', "thread_name", pid, tid, 0, "\"name\": \"" + name + "\"" );
+    event( out, 'M', "thread_sort_index", pid, tid, 0, "\"sort_index\": " + std::to_string( tid ) );
+}
+
+/* Emit the name of a device's trace process, once. Devices sort after the CPUs, in the
+* order of their numbers
+*/
+void ChromeTraceWriter::name_device( std::string& out, const Device device )
+{
+    const int pid = device_process( device );
+
+    // tid -1 stands for the process itself, tracks are never negative
+    if( !namedTracks_.insert( std::make_pair( pid, -1 ) ).second )
+    {
+        return;
+    }
+    std::string name = device_name( device );
+    name[0] = static_cast<char>( std::toupper( static_cast<unsigned char>( name[0] ) ) );
+    event( out, 'M', "process_name", pid, 0, 0, "\"name\": \"" + name + "\"" );
+    event( out, 'M', "process_sort_index", pid, 0, 0, "\"sort_index\": " + std::to_string( pid ) );
+}
+
+/* End the running process's slice on a CPU
+*/
+void ChromeTraceWriter::stop_running( std::string& out, const int cpu, const long long time )
+{
+    if( static_cast<std::size_t>( cpu ) < running_.size() && running_[cpu] != 0 )
+    {
+        event( out, 'E', process_name( running_[cpu] ), CPU_PROCESS, cpu, time );
+        running_[cpu] = 0;
+    }
+}
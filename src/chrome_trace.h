@@ -0,0 +1,68 @@
+/*
+* Filename: chrome_trace.h
+* Specifications for the ChromeTraceWriter object, which turns log records into the
+* Trace Event Format JSON that chrome://tracing and Perfetto load.
+*
+* Every simulated CPU gets a track showing which process held it, with instant events
+* where quanta expired, interrupts landed, processes arrived, were preempted or missed
+* their deadline. Every device is a trace process of its own, with a track showing its
+* I/O operations, and another track for each operation that overlaps them.
+*/
+
+#ifndef CHROME_TRACE_H
+#define CHROME_TRACE_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "log_record.h"
+
+/* Formats LogRecords as trace events. The records of a CPU have to come in order,
+* one writer sees every record of a trace */
+class ChromeTraceWriter
+{
+public:
+    // Appends the opening of the JSON document and the names of the tracks to out
+    void header( std::string& out );
+
+    // Appends the events of a record to out
+    void encode( const LogRecord& record, std::string& out );
+
+    // Ends every slice that is still open and closes the JSON document
+    void footer( std::string& out );
+
+private:
+    // Appends a single event, args is the JSON body of its arguments, if any
+    void event( std::string& out, const char phase, const std::string& name, const int pid,
+        const int tid, const long long time, const std::string& args = std::string() );
+
+    // Names a track the first time it is used
+    void name_track( std::string& out, const int pid, const int tid, const std::string& name );
+
+    // Names the trace process of a device the first time it is used
+    void name_device( std::string& out, const Device device );
+
+    // Ends the slice of the process running on a CPU, if there is one
+    void stop_running( std::string& out, const int cpu, const long long time );
+
+    // Process that holds each CPU, 0 if it's idle, indexed by track
+    std::vector<int> running_;
+
+    // Tracks of a device, numbered from 0. A process has at most one operation at a time
+    struct Lanes
+    {
+        std::map<int, int> busy; // lane of each process whose I/O runs, by process
+        std::set<int> free; // lanes that were used and are free again, the lowest is taken first
+        int count = 0; // lanes used so far
+    };
+    std::vector<Lanes> lanes_; // indexed by device
+
+    std::set<std::pair<int, int>> namedTracks_; // pid and tid of the tracks that have a name
+    long long lastTime_ = 0;
+    bool first_ = true;
+};
+
+#endif // CHROME_TRACE_H
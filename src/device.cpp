@@ -0,0 +1,46 @@
+#include "device.h"
+
+#include <cstring>
+
+namespace
+{
+    // indexed by Device
+    const char* const DEVICE_NAMES[DEVICE_COUNT] =
+    {
+        "", "hard drive", "keyboard", "monitor", "printer"
+    };
+}
+
+/* Look up a device by its name
+* @param name = description of an I/O operation
+* @return matching device, NO_DEVICE if the name is unknown
+*/
+Device device_from_name( const std::string& name )
+{
+    return device_from_name( name.data(), name.size() );
+}
+
+/* Look up a device by its name, without needing a string object
+* @param name = description of an I/O operation, not null terminated
+* @param length = length of the name
+* @return matching device, NO_DEVICE if the name is unknown
+*/
+Device device_from_name( const char* name, const std::size_t length )
+{
+    for( int device = HARD_DRIVE; device < DEVICE_COUNT; device++ )
+    {
+        if( std::strlen( DEVICE_NAMES[device] ) == length && 
+            std::memcmp( name, DEVICE_NAMES[device], length ) == 0 )
+        {
+            return static_cast<Device>( device );
+        }
+    }
+    return NO_DEVICE;
+}
+
+/* Device name getter
+*/
+const char* device_name( const Device device )
+{
+    return DEVICE_NAMES[device];
+}
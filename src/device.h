@@ -0,0 +1,25 @@
+/*
+* Filename: device.h
+* I/O devices known to the simulator.
+*/
+
+#ifndef DEVICE_H
+#define DEVICE_H
+
+#include <cstddef>
+#include <string>
+
+/* Devices an I/O operation can use */
+enum Device : unsigned char
+{
+    NO_DEVICE, HARD_DRIVE, KEYBOARD, MONITOR, PRINTER, DEVICE_COUNT
+};
+
+// Device matching a meta-data description such as "hard drive", NO_DEVICE if there is none
+Device device_from_name( const std::string& name );
+Device device_from_name( const char* name, const std::size_t length );
+
+// Name of the device as it appears in the meta-data file and in the log
+const char* device_name( const Device device );
+
+#endif // DEVICE_H
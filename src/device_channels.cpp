@@ -0,0 +1,226 @@
+#include "device_channels.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <string>
+
+namespace
+{
+    // indexed by DeviceChannels::Discipline
+    const char* const DISCIPLINE_NAMES[] = { "FIFO", "SJF", "SSTF", "SCAN", "C-LOOK" };
+}
+
+/* Constructor for the DeviceChannels class
+* @param channels = operations served at once, 0 for no limit
+* @param discipline = order in which waiting requests are served
+* @param disk = geometry and timing of a hard drive, disabled for other devices
+*/
+DeviceChannels::DeviceChannels( const int channels, const Discipline discipline, const DiskModel& disk )
+    : channels_( channels ), discipline_( discipline ), disk_( disk )
+{
+}
+
+/* A request arrives. It takes a free channel, or waits in the queue until one frees up
+* @param request = I/O operation asked for, at its time. Its duration grows by the
+* positioning time if it starts
+* @return true if it starts right away
+*/
+bool DeviceChannels::request( IORequest& request )
+{
+    requests_++;
+    if( !limited() || busy_ < channels_ )
+    {
+        // a device without a limit has no channels to run out of, and isn't released
+        if( limited() )
+        {
+            busy_++;
+        }
+        waits_.record( std::chrono::nanoseconds( 0 ) );
+        start( request, request.time, 0 );
+        return true;
+    }
+
+    account( request.time );
+    Entry entry;
+    entry.key = 0;
+    if( discipline_ == SJF )
+    {
+        entry.key = request.duration;
+    }
+    else if( discipline_ != FIFO )
+    {
+        // a request without a block is served wherever the arm happens to be
+        entry.key = request.operation.block >= 0 ? disk_.cylinder( request.operation.block ) : head_;
+    }
+    entry.sequence = sequence_++;
+    entry.request = request;
+    queue_.insert( entry );
+    queued_++;
+    maxDepth_ = std::max( maxDepth_, queue_.size() );
+    return false;
+}
+
+/* A channel is free again, the discipline picks the waiting request that gets it
+* @param now = simulated time the channel's operation finished
+* @param next = request that starts on the channel, if there is one
+* @return true if a request starts
+*/
+bool DeviceChannels::release( const std::chrono::nanoseconds now, IORequest& next )
+{
+    if( queue_.empty() )
+    {
+        busy_--;
+        return false;
+    }
+
+    account( now );
+    long long sweep = 0;
+    const std::set<Entry>::iterator selected = select( sweep );
+    next = selected->request;
+    queue_.erase( selected );
+    waits_.record( now - next.time );
+    start( next, std::max( now, next.time ), sweep );
+    return true;
+}
+
+/* Pick the waiting request to serve next. Requests on the same cylinder go in the order
+* they arrived in
+* @param sweep = receives the usec the arm takes to reach the edge of the disk before
+* it turns around, SCAN only
+* @return position of the request in the queue, which isn't empty
+*/
+std::set<DeviceChannels::Entry>::iterator DeviceChannels::select( long long& sweep )
+{
+    // first request at or past a cylinder, and the first one on the cylinder of another
+    auto at_or_after = [this]( const long long cylinder ){
+        Entry probe;
+        probe.key = cylinder;
+        probe.sequence = 0;
+        return queue_.lower_bound( probe );
+    };
+    auto first_on = [&at_or_after]( const std::set<Entry>::iterator entry ){
+        return at_or_after( entry->key );
+    };
+
+    switch( discipline_ )
+    {
+    case SSTF:
+    {
+        const std::set<Entry>::iterator above = at_or_after( head_ );
+        if( above == queue_.begin() )
+        {
+            return above;
+        }
+        const std::set<Entry>::iterator below = first_on( std::prev( above ) );
+        if( above == queue_.end() || head_ - below->key < above->key - head_ )
+        {
+            return below;
+        }
+        return above;
+    }
+    case SCAN:
+    {
+        if( inwards_ )
+        {
+            const std::set<Entry>::iterator next = at_or_after( head_ );
+            if( next != queue_.end() )
+            {
+                return next;
+            }
+            const int edge = disk_.cylinders() - 1;
+            sweep = disk_.seek( edge - head_ );
+            travel_ += edge - head_;
+            head_ = edge;
+            inwards_ = false;
+        }
+        const std::set<Entry>::iterator next = at_or_after( head_ + 1 );
+        if( next != queue_.begin() )
+        {
+            return first_on( std::prev( next ) );
+        }
+        sweep += disk_.seek( head_ );
+        travel_ += head_;
+        head_ = 0;
+        inwards_ = true;
+        return queue_.begin();
+    }
+    case C_LOOK:
+    {
+        const std::set<Entry>::iterator next = at_or_after( head_ );
+        return next != queue_.end() ? next : queue_.begin();
+    }
+    default:
+        return queue_.begin();
+    }
+}
+
+/* Start a request on a channel. With a disk model the arm moves to the request's
+* cylinder, then waits for its block to come around, and the operation takes that
+* much longer. Requests without a block don't move the arm
+* @param request = request that starts, its duration grows by the positioning time
+* @param time = simulated time it starts at
+* @param sweep = usec the arm already spent on its way, SCAN only
+*/
+void DeviceChannels::start( IORequest& request, const std::chrono::nanoseconds time, const long long sweep )
+{
+    const int block = request.operation.block;
+    if( !disk_.enabled() || block < 0 )
+    {
+        return;
+    }
+    const int cylinder = disk_.cylinder( block );
+    const int distance = std::abs( cylinder - head_ );
+    const long long seek = sweep + disk_.seek( distance );
+    const long long positioning = seek + disk_.rotation( block, time + std::chrono::microseconds( seek ) );
+    request.duration += positioning;
+    head_ = cylinder;
+    accesses_++;
+    travel_ += distance;
+    positioning_ += positioning;
+}
+
+/* Add the depth of the queue since it last changed to the integral
+* @param now = simulated time of the change, a change that seems earlier counts as simultaneous
+*/
+void DeviceChannels::account( const std::chrono::nanoseconds now )
+{
+    if( now > lastChange_ )
+    {
+        depthTime_ += static_cast<long double>( queue_.size() ) * ( now - lastChange_ ).count();
+        lastChange_ = now;
+    }
+}
+
+/* Write how long requests waited for a channel and how deep the queue got, times in msec
+* @param out = stream to write to
+* @param device = device the channels belong to, names the line
+* @param elapsed = length of the run, the mean depth is over it
+*/
+void DeviceChannels::write( std::ostream& out, const Device device, const std::chrono::nanoseconds elapsed ) const
+{
+    auto msec = []( const std::chrono::nanoseconds time ){
+        return time.count() / 1e6;
+    };
+    std::string name = device_name( device );
+    name[0] = static_cast<char>( std::toupper( static_cast<unsigned char>( name[0] ) ) );
+
+    char buffer[240];
+    std::snprintf( buffer, sizeof(buffer),
+        "%s: %d channel%s, %s, %llu requests, %llu queued, wait mean %.3f ms, p99 %.3f ms, max %.3f ms, "
+        "queue depth mean %.2f, max %zu\n",
+        name.c_str(), channels_, channels_ == 1 ? "" : "s", DISCIPLINE_NAMES[discipline_],
+        requests_, queued_, msec( waits_.mean() ), msec( waits_.percentile( 99 ) ), msec( waits_.max() ),
+        elapsed.count() > 0 ? static_cast<double>( depthTime_ / elapsed.count() ) : 0.0, maxDepth_ );
+    out << buffer;
+    if( disk_.enabled() )
+    {
+        std::snprintf( buffer, sizeof(buffer),
+            "%s: %llu accesses, arm moved %llu cylinders, %.1f per access, seek and rotation mean %.3f ms\n",
+            name.c_str(), accesses_, travel_, accesses_ > 0 ? static_cast<double>( travel_ ) / accesses_ : 0.0,
+            accesses_ > 0 ? positioning_ / 1e3 / accesses_ : 0.0 );
+        out << buffer;
+    }
+}
@@ -0,0 +1,106 @@
+/*
+* Filename: device_channels.h
+* Specifications for the DeviceChannels object, a device that serves a bounded number
+* of I/O operations at once and queues the rest.
+*/
+
+#ifndef DEVICE_CHANNELS_H
+#define DEVICE_CHANNELS_H
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <set>
+
+#include "disk_model.h"
+#include "host_stats.h"
+#include "operation.h"
+
+/* An I/O operation a program asked a device for */
+struct IORequest
+{
+    Operation operation;
+    long long duration; // usec the operation takes, a hard drive adds its positioning time
+    int programIndex; // index in the PCB table of the program that waits for it
+    int core; // core that gets the completion interrupt
+    std::chrono::nanoseconds time; // simulated time it was asked for
+};
+
+/* A device with a number of channels, each serves one operation at a time. Operations
+* that find every channel busy wait in the device's queue, in the order of its discipline.
+* A hard drive with a disk model also adds the time its arm takes to reach a request's
+* block to the operation when it starts, and can order its queue by block position.
+* Only keeps track of which request goes next, the caller decides when time passes and
+* locks it if several threads share it */
+class DeviceChannels
+{
+public:
+    enum Discipline
+    {
+        FIFO, // in the order they were asked for, also called FCFS
+        SJF, // shortest operation first
+        SSTF, // disk model only: closest cylinder to the head first
+        SCAN, // disk model only: the arm sweeps to the edge of the disk and back, serving on the way
+        C_LOOK // disk model only: serves going inwards, then jumps back to the outermost request
+    };
+
+    // channels = 0 serves every request at once, as if the device had no limit
+    explicit DeviceChannels( const int channels = 0, const Discipline discipline = FIFO,
+        const DiskModel& disk = DiskModel() );
+
+    bool limited() const { return channels_ > 0; }
+
+    // A request arrives, true if a channel was free and it starts right away. A request
+    // that starts gets its positioning time added to its duration
+    bool request( IORequest& request );
+
+    // A channel finished its operation at time now, true if a waiting request starts on it.
+    // Only limited devices have channels to release
+    bool release( const std::chrono::nanoseconds now, IORequest& next );
+
+    // Writes a line with the waits and the queue depth of the run, named after device
+    void write( std::ostream& out, const Device device, const std::chrono::nanoseconds elapsed ) const;
+
+private:
+    struct Entry
+    {
+        long long key; // what the discipline orders by, ties go to the earlier request
+        unsigned long long sequence;
+        IORequest request;
+        bool operator<( const Entry& other ) const
+        {
+            return key != other.key ? key < other.key : sequence < other.sequence;
+        }
+    };
+
+    // Charges the queue depth since the last change
+    void account( const std::chrono::nanoseconds now );
+
+    // Waiting request the discipline serves next, SCAN adds the arm's trip to the edge to sweep
+    std::set<Entry>::iterator select( long long& sweep );
+
+    // Starts a request at time, moving the arm to its block
+    void start( IORequest& request, const std::chrono::nanoseconds time, const long long sweep );
+
+    int channels_;
+    Discipline discipline_;
+    DiskModel disk_;
+    int head_ = 0; // cylinder the arm is on
+    bool inwards_ = true; // SCAN: direction the arm sweeps in
+    int busy_ = 0; // channels in use, limited devices only
+    std::set<Entry> queue_;
+    unsigned long long sequence_ = 0;
+
+    // Statistics, waits include the requests that didn't have to wait
+    unsigned long long requests_ = 0;
+    unsigned long long queued_ = 0;
+    LatencyHistogram waits_;
+    std::size_t maxDepth_ = 0;
+    long double depthTime_ = 0; // queue depth integrated over time, in nsec
+    std::chrono::nanoseconds lastChange_{ 0 };
+    unsigned long long accesses_ = 0; // requests that moved the arm to a block
+    unsigned long long travel_ = 0; // cylinders the arm moved over
+    long long positioning_ = 0; // usec of seeks and rotational latency
+};
+
+#endif // DEVICE_CHANNELS_H
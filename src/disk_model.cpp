@@ -0,0 +1,65 @@
+#include "disk_model.h"
+
+#include <cmath>
+
+/* Constructor for the DiskModel class
+* @param cylinders = number of cylinders, positive
+* @param blocksPerCylinder = blocks around each cylinder, positive
+* @param trackSeek = usec to move the arm to the next cylinder
+* @param fullSeek = usec to move the arm from the first cylinder to the last
+* @param rpm = revolutions per minute, 0 for no rotational latency
+*/
+DiskModel::DiskModel( const int cylinders, const int blocksPerCylinder, const long long trackSeek,
+    const long long fullSeek, const int rpm )
+    : cylinders_( cylinders ), blocksPerCylinder_( blocksPerCylinder ), trackSeek_( trackSeek ),
+    fullSeek_( fullSeek ), revolution_( rpm > 0 ? 60000000000LL / rpm : 0 )
+{
+}
+
+/* Cylinder of a block
+* @param block = block address, not negative
+*/
+int DiskModel::cylinder( const int block ) const
+{
+    return block / blocksPerCylinder_ % cylinders_;
+}
+
+/* Seek time, a short seek is mostly the arm speeding up and settling, so the time grows
+* with the square root of the distance
+* @param distance = cylinders the arm moves over
+* @return usec
+*/
+long long DiskModel::seek( const int distance ) const
+{
+    if( distance <= 0 )
+    {
+        return 0;
+    }
+    if( cylinders_ <= 2 )
+    {
+        return trackSeek_;
+    }
+    const double fraction = std::sqrt( static_cast<double>( distance - 1 ) / ( cylinders_ - 2 ) );
+    return trackSeek_ + static_cast<long long>( std::llround( ( fullSeek_ - trackSeek_ ) * fraction ) );
+}
+
+/* Rotational latency. The disk turns at a constant speed from the start of the
+* simulation, with block 0 of every cylinder under the head at time 0
+* @param block = block address, not negative
+* @param arrival = simulated time the head reached the block's cylinder
+* @return usec until the block passes under the head, rounded up
+*/
+long long DiskModel::rotation( const int block, const std::chrono::nanoseconds arrival ) const
+{
+    if( revolution_ == 0 )
+    {
+        return 0;
+    }
+    const long long position = static_cast<long long>( block % blocksPerCylinder_ ) * revolution_ / blocksPerCylinder_;
+    long long wait = ( position - arrival.count() % revolution_ ) % revolution_;
+    if( wait < 0 )
+    {
+        wait += revolution_;
+    }
+    return ( wait + 999 ) / 1000;
+}
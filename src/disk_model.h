@@ -0,0 +1,44 @@
+/*
+* Filename: disk_model.h
+* Specifications for the DiskModel object, the geometry and timing of a hard drive.
+*/
+
+#ifndef DISK_MODEL_H
+#define DISK_MODEL_H
+
+#include <chrono>
+
+/* A hard drive with a single arm. Blocks are numbered along the cylinders, from the
+* outermost inwards, blocksPerCylinder of them spread evenly around each. Moving the arm
+* takes a track-to-track seek for one cylinder, growing with the square root of the
+* distance to a full seek across the disk, then the block has to rotate under the head.
+* All times in usec */
+class DiskModel
+{
+public:
+    // A disk without cylinders, operations cost their cycles only
+    DiskModel() = default;
+    DiskModel( const int cylinders, const int blocksPerCylinder, const long long trackSeek,
+        const long long fullSeek, const int rpm );
+
+    bool enabled() const { return cylinders_ > 0; }
+    int cylinders() const { return cylinders_; }
+
+    // Cylinder a block lies on, addresses past the last cylinder wrap around to the first
+    int cylinder( const int block ) const;
+
+    // Time to move the arm over a distance of cylinders, 0 if it doesn't move
+    long long seek( const int distance ) const;
+
+    // Time from when the head got to a block's cylinder until the block is under it
+    long long rotation( const int block, const std::chrono::nanoseconds arrival ) const;
+
+private:
+    int cylinders_ = 0;
+    int blocksPerCylinder_ = 1;
+    long long trackSeek_ = 0;
+    long long fullSeek_ = 0;
+    long long revolution_ = 0; // nsec per revolution, 0 if the disk doesn't spin
+};
+
+#endif // DISK_MODEL_H
@@ -0,0 +1,156 @@
+#include "host_stats.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+    // Buckets needed for every 64-bit value, see LatencyHistogram::bucket()
+    const int BUCKETS = 60 * 16 + 16;
+
+    // microseconds with nanosecond precision
+    double usec( const std::chrono::nanoseconds time )
+    {
+        return time.count() / 1e3;
+    }
+}
+
+/* Constructor for the LatencyHistogram class
+*/
+LatencyHistogram::LatencyHistogram() : counts_( BUCKETS, 0 )
+{
+}
+
+/* Count a duration
+* @param value = duration to count
+*/
+void LatencyHistogram::record( const std::chrono::nanoseconds value )
+{
+    const std::uint64_t nanoseconds = value.count() > 0 ? static_cast<std::uint64_t>( value.count() ) : 0;
+    counts_[ bucket( nanoseconds ) ]++;
+    count_++;
+    min_ = std::min( min_, nanoseconds );
+    max_ = std::max( max_, nanoseconds );
+    total_ += nanoseconds;
+}
+
+/* Add another histogram's counts to this one
+* @param other = histogram to add
+*/
+void LatencyHistogram::merge( const LatencyHistogram& other )
+{
+    for( int i = 0; i < BUCKETS; i++ )
+    {
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    min_ = std::min( min_, other.min_ );
+    max_ = std::max( max_, other.max_ );
+    total_ += other.total_;
+}
+
+/* Min getter, 0 if nothing was recorded
+*/
+std::chrono::nanoseconds LatencyHistogram::min() const
+{
+    return std::chrono::nanoseconds( count_ > 0 ? min_ : 0 );
+}
+
+/* Mean getter, 0 if nothing was recorded
+*/
+std::chrono::nanoseconds LatencyHistogram::mean() const
+{
+    return std::chrono::nanoseconds( count_ > 0 ? static_cast<long long>( total_ / count_ ) : 0 );
+}
+
+/* Find a percentile by walking the buckets up to its rank
+* @param percent = between 0 and 100
+* @return largest value of the bucket the rank falls into, but never more than the maximum
+*/
+std::chrono::nanoseconds LatencyHistogram::percentile( const double percent ) const
+{
+    if( count_ == 0 )
+    {
+        return std::chrono::nanoseconds( 0 );
+    }
+    std::uint64_t rank = static_cast<std::uint64_t>( percent / 100.0 * count_ + 0.5 );
+    rank = std::max<std::uint64_t>( std::min( rank, count_ ), 1 );
+
+    std::uint64_t seen = 0;
+    for( int i = 0; i < BUCKETS; i++ )
+    {
+        seen += counts_[i];
+        if( seen >= rank )
+        {
+            return std::chrono::nanoseconds( std::max( std::min( highest( i ), max_ ), min_ ) );
+        }
+    }
+    return max();
+}
+
+/* Values below 2 * SUB_BUCKETS get a bucket each. Above that a value is shifted right
+* until its top 5 bits are left, which picks one of 16 buckets per power of two
+* @param value = nanoseconds
+* @return bucket index
+*/
+int LatencyHistogram::bucket( std::uint64_t value )
+{
+    int shift = 0;
+    while( value >= 2 * SUB_BUCKETS )
+    {
+        value >>= 1;
+        shift++;
+    }
+    return shift * SUB_BUCKETS + static_cast<int>( value );
+}
+
+/* Largest value that falls into a bucket
+* @param bucket = bucket index
+*/
+std::uint64_t LatencyHistogram::highest( const int bucket )
+{
+    if( bucket < 2 * SUB_BUCKETS )
+    {
+        return bucket;
+    }
+    const int shift = bucket / SUB_BUCKETS - 1;
+    const std::uint64_t top = bucket % SUB_BUCKETS + SUB_BUCKETS;
+    return ( ( top + 1 ) << shift ) - 1;
+}
+
+/* Add another core's measurements to these
+* @param other = measurements to add
+*/
+void HostStats::merge( const HostStats& other )
+{
+    sleepOvershoot.merge( other.sleepOvershoot );
+    selection.merge( other.selection );
+    interruptDelivery.merge( other.interruptDelivery );
+    dispatches += other.dispatches;
+    contextSwitches += other.contextSwitches;
+}
+
+/* Write the measurements, all times in microseconds
+* @param out = stream to write to
+*/
+void HostStats::write( std::ostream& out ) const
+{
+    const char* const names[] = { "Sleep overshoot", "Scheduler decision", "Interrupt delivery" };
+    const LatencyHistogram* const histograms[] = { &sleepOvershoot, &selection, &interruptDelivery };
+    char buffer[200];
+
+    out << "Host overhead (usec):\n";
+    for( int i = 0; i < 3; i++ )
+    {
+        const LatencyHistogram &histogram = *histograms[i];
+        std::snprintf( buffer, sizeof(buffer),
+            "  %-19s %10llu samples, mean %.3f, p50 %.3f, p90 %.3f, p99 %.3f, p99.9 %.3f, max %.3f\n",
+            names[i], static_cast<unsigned long long>( histogram.count() ), usec( histogram.mean() ),
+            usec( histogram.percentile( 50 ) ), usec( histogram.percentile( 90 ) ),
+            usec( histogram.percentile( 99 ) ), usec( histogram.percentile( 99.9 ) ), usec( histogram.max() ) );
+        out << buffer;
+    }
+    std::snprintf( buffer, sizeof(buffer), "  Context switches    %10llu of %llu dispatches\n",
+        contextSwitches, dispatches );
+    out << buffer;
+}
@@ -0,0 +1,70 @@
+/*
+* Filename: host_stats.h
+* Specifications for the LatencyHistogram and HostStats objects, which measure how much
+* the host machine got in the way of a run.
+*/
+
+#ifndef HOST_STATS_H
+#define HOST_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/* Histogram of durations with a relative precision of about 3% over the whole range,
+* as in HdrHistogram: values below 32 ns get a bucket each, every power of two above
+* that is split into 16 buckets. Recording is O(1) and never allocates */
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    // Counts a duration, negative ones count as 0
+    void record( const std::chrono::nanoseconds value );
+
+    // Adds the counts of another histogram
+    void merge( const LatencyHistogram& other );
+
+    std::uint64_t count() const { return count_; }
+    std::chrono::nanoseconds min() const;
+    std::chrono::nanoseconds max() const { return std::chrono::nanoseconds( max_ ); }
+    std::chrono::nanoseconds mean() const;
+
+    // Smallest value that at least percent of the recorded values are at or below,
+    // accurate to the width of its bucket
+    std::chrono::nanoseconds percentile( const double percent ) const;
+
+private:
+    static const int SUB_BUCKETS = 16;
+
+    // Bucket a value falls into, and the largest value a bucket holds
+    static int bucket( std::uint64_t value );
+    static std::uint64_t highest( const int bucket );
+
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t count_ = 0;
+    std::uint64_t min_ = UINT64_MAX;
+    std::uint64_t max_ = 0;
+    long double total_ = 0;
+};
+
+/* Host-side measurements of a simulated CPU. Each core records into its own, so
+* recording needs no locks, and they are merged at the end of the run */
+struct HostStats
+{
+    using Clock = std::chrono::steady_clock;
+
+    LatencyHistogram sleepOvershoot; // real-time mode: how much longer a cycle slept than asked
+    LatencyHistogram selection; // time taken to pick the next program from the ready queues
+    LatencyHistogram interruptDelivery; // from an I/O completion being posted until a core took it
+    unsigned long long dispatches = 0;
+    unsigned long long contextSwitches = 0; // dispatches of another program than the core ran last
+
+    void merge( const HostStats& other );
+
+    // Writes a line per histogram plus the context switches
+    void write( std::ostream& out ) const;
+};
+
+#endif // HOST_STATS_H
@@ -0,0 +1,179 @@
+/*
+* Filename: indexed_heap.h
+* Specifications for the IndexedHeap object. Binary min-heap of small integer IDs that
+* knows where every ID is, so any of them can be removed or re-keyed.
+*/
+
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+/* Min-heap of IDs, ordered by a key that is stored along with each ID. The position of
+* every ID is tracked, so besides push and pop an ID can be removed or given a new key
+* in O(log n). IDs are indices, such as slots of the PCB table, and may each be in the
+* heap once */
+template<typename Key>
+class IndexedHeap
+{
+public:
+    // Makes room for IDs below count without reallocating
+    void reserve( const std::size_t count );
+
+    bool empty() const { return heap_.empty(); }
+    std::size_t size() const { return heap_.size(); }
+    bool contains( const int id ) const;
+
+    // Adds an ID that isn't in the heap yet
+    void push( const int id, const Key& key );
+
+    // ID with the smallest key and its key, the heap can't be empty
+    int top() const { return heap_.front().id; }
+    const Key& top_key() const { return heap_.front().key; }
+
+    // Removes and returns the ID with the smallest key
+    int pop();
+
+    // Removes an ID that is in the heap
+    void remove( const int id );
+
+    // Changes the key of an ID that is in the heap, up or down
+    void update( const int id, const Key& key );
+
+private:
+    struct Entry
+    {
+        Key key;
+        int id;
+    };
+
+    // Moves an entry towards the root or the leaves until the heap is in order again
+    void sift_up( std::size_t position );
+    void sift_down( std::size_t position );
+
+    // Puts an entry at a position and records where it is
+    void place( const std::size_t position, const Entry& entry );
+
+    std::vector<Entry> heap_;
+    std::vector<int> positions_; // by ID, -1 if the ID isn't in the heap
+};
+
+template<typename Key>
+void IndexedHeap<Key>::reserve( const std::size_t count )
+{
+    heap_.reserve( count );
+    if( positions_.size() < count )
+    {
+        positions_.resize( count, -1 );
+    }
+}
+
+template<typename Key>
+bool IndexedHeap<Key>::contains( const int id ) const
+{
+    return id >= 0 && static_cast<std::size_t>( id ) < positions_.size() && positions_[id] >= 0;
+}
+
+template<typename Key>
+void IndexedHeap<Key>::push( const int id, const Key& key )
+{
+    assert( !contains( id ) );
+    if( static_cast<std::size_t>( id ) >= positions_.size() )
+    {
+        positions_.resize( id + 1, -1 );
+    }
+    heap_.push_back( Entry{ key, id } );
+    positions_[id] = static_cast<int>( heap_.size() - 1 );
+    sift_up( heap_.size() - 1 );
+}
+
+template<typename Key>
+int IndexedHeap<Key>::pop()
+{
+    const int id = heap_.front().id;
+    remove( id );
+    return id;
+}
+
+template<typename Key>
+void IndexedHeap<Key>::remove( const int id )
+{
+    assert( contains( id ) );
+    const std::size_t position = positions_[id];
+    positions_[id] = -1;
+
+    // the last entry fills the hole, then moves whichever way its key requires
+    const Entry last = heap_.back();
+    heap_.pop_back();
+    if( position == heap_.size() )
+    {
+        return;
+    }
+    place( position, last );
+    sift_up( position );
+    sift_down( positions_[last.id] );
+}
+
+template<typename Key>
+void IndexedHeap<Key>::update( const int id, const Key& key )
+{
+    assert( contains( id ) );
+    const std::size_t position = positions_[id];
+    heap_[position].key = key;
+    sift_up( position );
+    sift_down( positions_[id] );
+}
+
+template<typename Key>
+void IndexedHeap<Key>::sift_up( std::size_t position )
+{
+    const Entry entry = heap_[position];
+    while( position > 0 )
+    {
+        const std::size_t parent = ( position - 1 ) / 2;
+        if( !( entry.key < heap_[parent].key ) )
+        {
+            break;
+        }
+        place( position, heap_[parent] );
+        position = parent;
+    }
+    place( position, entry );
+}
+
+template<typename Key>
+void IndexedHeap<Key>::sift_down( std::size_t position )
+{
+    const Entry entry = heap_[position];
+    const std::size_t count = heap_.size();
+    while( true )
+    {
+        std::size_t child = 2 * position + 1;
+        if( child >= count )
+        {
+            break;
+        }
+        if( child + 1 < count && heap_[child + 1].key < heap_[child].key )
+        {
+            child++;
+        }
+        if( !( heap_[child].key < entry.key ) )
+        {
+            break;
+        }
+        place( position, heap_[child] );
+        position = child;
+    }
+    place( position, entry );
+}
+
+template<typename Key>
+void IndexedHeap<Key>::place( const std::size_t position, const Entry& entry )
+{
+    heap_[position] = entry;
+    positions_[entry.id] = static_cast<int>( position );
+}
+
+#endif // INDEXED_HEAP_H
@@ -0,0 +1,100 @@
+#include "log_record.h"
+
+#include <cstdio>
+
+namespace
+{
+    // indexed by EventCode
+    const char* const EVENT_NAMES[] =
+    {
+        "simulator_start", "simulator_end",
+        "os_preparing", "os_selecting", "os_idle",
+        "process_start", "process_io", "process_run", "process_run_end", "process_remove",
+        "quantum_expired", "io_start", "io_end",
+        "process_arrive", "deadline_missed", "process_preempted"
+    };
+}
+
+/* Event name getter
+*/
+const char* event_name( const EventCode event )
+{
+    return EVENT_NAMES[event];
+}
+
+/* Format a record the way the simulator has always printed it
+* @param record to format
+* @param out = string the formatted line is appended to
+*/
+void format_record( const LogRecord& record, std::string& out )
+{
+    char buffer[128];
+    int length = std::snprintf( buffer, sizeof(buffer), "%lld.%06lld - ",
+        record.time / 1000000, record.time % 1000000 );
+    out.append( buffer, length );
+    if( record.cpu != 0 )
+    {
+        length = std::snprintf( buffer, sizeof(buffer), "CPU %d - ", record.cpu );
+        out.append( buffer, length );
+    }
+
+    const std::string pid = std::to_string( record.processID );
+    const char* access = record.input ? " input" : " output";
+    switch( record.event )
+    {
+    case SIMULATOR_START:
+        out += "Simulator program starting";
+        break;
+    case SIMULATOR_END:
+        out += "Simulator program ending";
+        break;
+    case OS_PREPARING:
+        out += "OS: preparing all processes";
+        break;
+    case OS_SELECTING:
+        out += "OS: selecting next process";
+        break;
+    case OS_IDLE:
+        out += "OS Idle: Waiting for I/O to finish";
+        break;
+    case PROCESS_START:
+        out.append("OS: starting process ").append(pid);
+        break;
+    case PROCESS_IO:
+        out.append("Process ").append(pid).append(": starting I/O");
+        break;
+    case PROCESS_RUN:
+        out.append("Process ").append(pid).append(": processing action");
+        break;
+    case PROCESS_RUN_END:
+        out.append("Process ").append(pid).append(": end processing action");
+        break;
+    case PROCESS_REMOVE:
+        out.append("OS: removing process ").append(pid);
+        break;
+    case QUANTUM_EXPIRED:
+        out += "Interrupt: quantum expired";
+        break;
+    case IO_START:
+        out.append("I/O: process ").append(pid).append(" starting ")
+            .append(device_name(record.device)).append(access);
+        break;
+    case IO_END:
+        out.append("Interrupt: process ").append(pid).append(" done with ")
+            .append(device_name(record.device)).append(access);
+        break;
+    case PROCESS_ARRIVE:
+        out += "OS: new process arrived";
+        break;
+    case DEADLINE_MISSED:
+        out.append("OS: process ").append(pid).append(" missed its deadline by ")
+            .append(std::to_string(record.value)).append(" msec");
+        break;
+    case PROCESS_PREEMPTED:
+        out.append("Interrupt: process ").append(pid).append(" preempted");
+        break;
+    case EVENT_COUNT:
+        break;
+    }
+    out += '\n';
+}
@@ -0,0 +1,44 @@
+/*
+* Filename: log_record.h
+* Specifications for LogRecord, the fixed-size form of a single log message.
+*/
+
+#ifndef LOG_RECORD_H
+#define LOG_RECORD_H
+
+#include <string>
+
+#include "device.h"
+
+/* Everything the simulator can log */
+enum EventCode : unsigned char
+{
+    SIMULATOR_START, SIMULATOR_END,
+    OS_PREPARING, OS_SELECTING, OS_IDLE,
+    PROCESS_START, PROCESS_IO, PROCESS_RUN, PROCESS_RUN_END, PROCESS_REMOVE,
+    QUANTUM_EXPIRED, IO_START, IO_END,
+    PROCESS_ARRIVE, DEADLINE_MISSED, PROCESS_PREEMPTED,
+    EVENT_COUNT
+};
+
+/* A log message before formatting. Trivially copyable, so records can be passed
+* between threads without allocating */
+struct LogRecord
+{
+    long long time; // microseconds since the simulation started, in simulated time
+    long long wallTime; // microseconds since the simulation started, in real time
+    int processID;
+    EventCode event;
+    Device device; // I/O events only
+    bool input; // I/O events only, false for output
+    unsigned char cpu; // simulated CPU the event happened on counting from 1, 0 with a single CPU
+    int value; // DEADLINE_MISSED only: msec the job finished after its deadline
+};
+
+// Short name of an event, as used in CSV output
+const char* event_name( const EventCode event );
+
+// Appends the text form of record to out, e.g. "0.030000 - Interrupt: quantum expired\n"
+void format_record( const LogRecord& record, std::string& out );
+
+#endif // LOG_RECORD_H
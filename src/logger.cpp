@@ -0,0 +1,269 @@
+#include "logger.h"
+
+namespace
+{
+    // Formatted text is written out once it grows past this size
+    const std::size_t FLUSH_SIZE = 1 << 16;
+
+    // Smallest power of two >= n
+    std::size_t round_up_pow2( const std::size_t n )
+    {
+        std::size_t size = 1;
+        while( size < n )
+        {
+            size <<= 1;
+        }
+        return size;
+    }
+}
+
+/* Constructor for the Logger class, starts the writer thread
+* @param outputs = streams every record is written to
+* @param format = text, binary trace or trace event output
+* @param producers = number of threads that will log, each one gets its own ring
+* @param capacity = records per ring, rounded up to a power of two
+* @param overflow = whether a producer waits or drops the record when its ring is full
+*/
+Logger::Logger( const std::vector<std::ostream*> outputs, const Format format, const int producers,
+    const std::size_t capacity, const Overflow overflow )
+    : outputs_( outputs ), format_( format ), mask_( round_up_pow2(capacity) - 1 ), 
+    overflow_( overflow )
+{
+    for( int i = 0; i < producers; i++ )
+    {
+        rings_.emplace_back( new Ring( mask_ + 1 ) );
+    }
+    buffer_.reserve( FLUSH_SIZE * 2 );
+    if( format_ == BINARY )
+    {
+        encoder_.header( buffer_ );
+    }
+    else if( format_ == CHROME )
+    {
+        chromeWriter_.header( buffer_ );
+    }
+    thread_ = std::thread( [this](){ run(); } );
+}
+
+Logger::~Logger()
+{
+    stop();
+}
+
+/* Queue a record for the writer thread
+* @param producer = ring owned by the calling thread
+* @param record to log
+*/
+void Logger::log( const int producer, const LogRecord& record )
+{
+    Ring &ring = *rings_[producer];
+    std::size_t head = ring.head.load( std::memory_order_relaxed );
+    while( head - ring.tail.load( std::memory_order_acquire ) > mask_ )
+    {
+        // the writer may be holding records back for the watermark, a full ring
+        // is written out regardless
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            wakeup_.notify_one();
+        }
+
+        if( overflow_ == DROP )
+        {
+            dropped_.fetch_add( 1, std::memory_order_relaxed );
+            return;
+        }
+
+        // BLOCK: give the writer a chance to catch up
+        std::this_thread::yield();
+    }
+
+    ring.records[ head & mask_ ] = record;
+    ring.head.store( head + 1, std::memory_order_release );
+
+    // pairs with the fence in run(), either the writer sees the record or we see it sleeping
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    if( sleeping_.load( std::memory_order_relaxed ) )
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        wakeup_.notify_one();
+    }
+}
+
+/* Move the watermark forward and let the writer catch up to it
+* @param time = records stamped before this time can be written
+*/
+void Logger::set_watermark( const long long time )
+{
+    watermark_.store( time );
+    std::lock_guard<std::mutex> lock( mutex_ );
+    wakeup_.notify_one();
+}
+
+/* Stop the writer thread once it has written everything that was logged
+*/
+void Logger::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        watermark_ = std::numeric_limits<long long>::max();
+        running_ = false;
+    }
+    wakeup_.notify_one();
+    if( thread_.joinable() )
+    {
+        thread_.join();
+    }
+}
+
+/* Dropped records getter
+*/
+unsigned long long Logger::dropped() const
+{
+    return dropped_.load();
+}
+
+/* Writer thread. Drains the rings until they are empty, writes the text out, and
+* sleeps until a producer logs something new. Records held back for the watermark
+* don't wake it, moving the watermark or filling up a ring does
+*/
+void Logger::run()
+{
+    while( true )
+    {
+        while( drain() )
+        {
+            if( buffer_.size() >= FLUSH_SIZE )
+            {
+                flush();
+            }
+        }
+        flush();
+
+        std::unique_lock<std::mutex> lock( mutex_ );
+        sleeping_.store( true, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+
+        bool empty = true;
+        for( const auto &ring : rings_ )
+        {
+            if( ring->tail.load( std::memory_order_relaxed ) != ring->head.load( std::memory_order_acquire ) )
+            {
+                empty = false;
+            }
+        }
+        if( empty && !running_ )
+        {
+            break;
+        }
+        if( empty )
+        {
+            wakeup_.wait( lock );
+        }
+        else if( !ready() )
+        {
+            sleeping_.store( false, std::memory_order_relaxed );
+            wakeup_.wait( lock );
+        }
+        sleeping_.store( false, std::memory_order_relaxed );
+    }
+
+    // the JSON document is only complete once the last record is in
+    if( format_ == CHROME )
+    {
+        chromeWriter_.footer( buffer_ );
+        flush();
+    }
+}
+
+/* Format every record currently in the rings
+* Rings are merged by timestamp, so records from different threads come out in order
+* @return true if any record was formatted
+*/
+bool Logger::drain()
+{
+    bool any = false;
+    while( true )
+    {
+        Ring* oldest = nullptr;
+        bool full = false;
+        for( const auto &ring : rings_ )
+        {
+            std::size_t tail = ring->tail.load( std::memory_order_relaxed );
+            std::size_t head = ring->head.load( std::memory_order_acquire );
+            if( tail == head )
+            {
+                continue;
+            }
+            full = full || head - tail > mask_;
+            if( oldest == nullptr || ring->records[ tail & mask_ ].time <
+                oldest->records[ oldest->tail.load( std::memory_order_relaxed ) & mask_ ].time )
+            {
+                oldest = ring.get();
+            }
+        }
+
+        if( oldest == nullptr )
+        {
+            return any;
+        }
+
+        std::size_t tail = oldest->tail.load( std::memory_order_relaxed );
+        if( oldest->records[ tail & mask_ ].time >= watermark_.load() && !full )
+        {
+            return any;
+        }
+        if( format_ == BINARY )
+        {
+            encoder_.encode( oldest->records[ tail & mask_ ], buffer_ );
+        }
+        else if( format_ == CHROME )
+        {
+            chromeWriter_.encode( oldest->records[ tail & mask_ ], buffer_ );
+        }
+        else
+        {
+            format_record( oldest->records[ tail & mask_ ], buffer_ );
+        }
+        oldest->tail.store( tail + 1, std::memory_order_release );
+        any = true;
+
+        if( buffer_.size() >= FLUSH_SIZE )
+        {
+            return true;
+        }
+    }
+}
+
+/* Check whether the writer can make progress while records are held back
+* @return true if a record is older than the watermark or a ring is full
+*/
+bool Logger::ready() const
+{
+    const long long watermark = watermark_.load();
+    for( const auto &ring : rings_ )
+    {
+        std::size_t tail = ring->tail.load( std::memory_order_relaxed );
+        std::size_t head = ring->head.load( std::memory_order_acquire );
+        if( tail != head && ( head - tail > mask_ || ring->records[ tail & mask_ ].time < watermark ) )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Write the formatted output to every output
+*/
+void Logger::flush()
+{
+    if( buffer_.empty() )
+    {
+        return;
+    }
+    for( std::ostream* output : outputs_ )
+    {
+        output->write( buffer_.data(), buffer_.size() );
+        output->flush();
+    }
+    buffer_.clear();
+}
@@ -0,0 +1,112 @@
+/*
+* Filename: logger.h
+* Specifications for the Logger object. Formats and writes log records on a
+* dedicated thread so logging never blocks the simulation on output.
+*/
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "chrome_trace.h"
+#include "log_record.h"
+#include "trace.h"
+
+/* Asynchronous logger. Each producer thread owns a single-producer single-consumer
+* ring of LogRecords; the writer thread merges the rings in timestamp order, formats
+* the records and writes them out in large chunks. */
+class Logger
+{
+public:
+    // How records are written out: readable text, the binary trace format or
+    // Trace Event Format JSON for chrome://tracing and Perfetto
+    enum Format
+    {
+        TEXT, BINARY, CHROME
+    };
+
+    // What a producer does when its ring is full
+    enum Overflow
+    {
+        BLOCK, DROP
+    };
+
+    // Starts the writer thread. Outputs must stay open until the logger is destroyed
+    Logger( const std::vector<std::ostream*> outputs, const Format format, const int producers,
+        const std::size_t capacity, const Overflow overflow );
+    ~Logger();
+
+    Logger( const Logger& ) = delete;
+    Logger& operator=( const Logger& ) = delete;
+
+    // Queue a record, producer is the index of the calling thread's ring
+    void log( const int producer, const LogRecord& record );
+
+    // Records stamped at or after the watermark stay queued until it moves past them, so
+    // producers running ahead of the others still come out in order, ties included.
+    // Everything stamped earlier has to be logged by the time the watermark is set
+    void set_watermark( const long long time );
+
+    // Writes every queued record and stops the writer thread
+    void stop();
+
+    // Number of records lost because a ring was full
+    unsigned long long dropped() const;
+
+private:
+    /* Fixed-size ring, head and tail only ever increase and are masked on access.
+    * Padding keeps the producer's and the writer's counters on separate cache lines */
+    struct Ring
+    {
+        explicit Ring( const std::size_t capacity ) : records( capacity ) {}
+        std::vector<LogRecord> records;
+        char padding0[64];
+        std::atomic<std::size_t> head{ 0 }; // next slot to write, owned by the producer
+        char padding1[64];
+        std::atomic<std::size_t> tail{ 0 }; // next slot to read, owned by the writer
+        char padding2[64];
+    };
+
+    // Writer thread body
+    void run();
+
+    // Formats every record that is currently queued, oldest first. False if there were none
+    bool drain();
+
+    // true if drain() has something to write: a record before the watermark, or a full ring
+    bool ready() const;
+
+    // Writes the formatted text to every output
+    void flush();
+
+    std::vector<std::ostream*> outputs_;
+    const Format format_;
+    TraceEncoder encoder_;
+    ChromeTraceWriter chromeWriter_;
+    std::vector<std::unique_ptr<Ring>> rings_;
+    const std::size_t mask_;
+    const Overflow overflow_;
+    std::atomic<unsigned long long> dropped_{ 0 };
+    std::atomic<long long> watermark_{ std::numeric_limits<long long>::max() };
+
+    std::string buffer_; // formatted output waiting to be written, only used by the writer
+
+    // Producers only take the mutex to wake the writer when it is asleep
+    std::atomic<bool> sleeping_{ false };
+    std::atomic<bool> running_{ true };
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::thread thread_;
+};
+
+#endif // LOGGER_H
@@ -11,29 +11,60 @@
 * Usage: The executable requires the configuration file as a command line 
 * argument.
 *   $ ./sim03 config_file.cnf
+*
+* The meta-data file from the configuration can also be compiled into a binary
+* workload, which can then be used as the configuration's file path to skip parsing.
+*   $ ./sim03 --compile config_file.cnf workload_file
+*
+* A sweep file runs a configuration with every combination of the settings it lists,
+* several runs at a time.
+*   $ ./sim03 --sweep sweep_file
 */
 
 /* Dependencies */
 #include <iostream>
+#include <string>
 #include "simulator.h"
+#include "sweep.h"
 
 /* Main */
 int main(const int argc, char const *argv[])
 {
     // Check to see if a configuration file was provided
-    if( argc != 2 )
+    bool compile = argc == 4 && std::string( argv[1] ) == "--compile";
+    bool sweep = argc == 3 && std::string( argv[1] ) == "--sweep";
+    if( argc != 2 && !compile && !sweep )
     {
         std::cerr 
         << "Error: Incorrect number of command line arguments" << std::endl
-        << "Example usage: " << argv[0] << " config_file.cnf" << std::endl;        
+        << "Example usage: " << argv[0] << " config_file.cnf" << std::endl
+        << "               " << argv[0] << " --compile config_file.cnf workload_file" << std::endl
+        << "               " << argv[0] << " --sweep sweep_file" << std::endl;
         return EXIT_FAILURE;
     }
 
-    // Run the simulation with provided config file
+    // Run the simulation with provided config file, or compile its workload
     try
     {
-        Simulator simulator( argv[1] );
-        simulator.run();
+        if( compile )
+        {
+            Simulator simulator( argv[2] );
+            simulator.compile( argv[3] );
+        }
+        else if( sweep )
+        {
+            Sweep runs( argv[2] );
+            if( runs.run( std::cout ) > 0 )
+            {
+                return EXIT_FAILURE;
+            }
+        }
+        else
+        {
+            Simulator simulator( argv[1] );
+            simulator.run();
+            simulator.print_statistics( std::cout );
+        }
     }
     
     // Catch unfixable errors, e.g. file not found
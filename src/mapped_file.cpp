@@ -0,0 +1,85 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Constructor for the MappedFile class, maps the file read-only
+* @param filePath = file to map
+* @except Throws exception if the file can't be opened or mapped
+*/
+MappedFile::MappedFile( const std::string& filePath )
+{
+    int fd = ::open( filePath.c_str(), O_RDONLY );
+    struct stat info;
+    if( fd < 0 || ::fstat( fd, &info ) != 0 )
+    {
+        if( fd >= 0 )
+        {
+            ::close( fd );
+        }
+        throw std::runtime_error( "Error: Unable to open file " + filePath + "\n" );
+    }
+
+    size_ = info.st_size;
+
+    // an empty file can't be mapped, but there is nothing to read anyway
+    if( size_ > 0 )
+    {
+        void* data = ::mmap( nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if( data == MAP_FAILED )
+        {
+            ::close( fd );
+            throw std::runtime_error( "Error: Unable to open file " + filePath + "\n" );
+        }
+        ::madvise( data, size_, MADV_SEQUENTIAL );
+        data_ = static_cast<const char*>( data );
+    }
+    ::close( fd );
+}
+
+MappedFile::~MappedFile()
+{
+    if( data_ != nullptr )
+    {
+        ::munmap( const_cast<char*>( data_ ), size_ );
+    }
+}
+
+/* Start of the file contents
+*/
+const char* MappedFile::begin() const
+{
+    return data_;
+}
+
+/* One past the end of the file contents
+*/
+const char* MappedFile::end() const
+{
+    return data_ + size_;
+}
+
+/* File size getter
+*/
+std::size_t MappedFile::size() const
+{
+    return size_;
+}
+
+/* Let the OS reclaim the part of the file that was already read
+* Used when streaming through large files, so memory use doesn't grow with them
+* @param position = everything before the page this is in gets released
+*/
+void MappedFile::release( const char* position )
+{
+    std::size_t pageSize = ::sysconf( _SC_PAGESIZE );
+    std::size_t length = ( position - data_ ) / pageSize * pageSize;
+    if( length > released_ )
+    {
+        ::madvise( const_cast<char*>( data_ ) + released_, length - released_, MADV_DONTNEED );
+        released_ = length;
+    }
+}
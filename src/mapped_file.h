@@ -0,0 +1,37 @@
+/*
+* Filename: mapped_file.h
+* Specifications for the MappedFile object, a read-only memory mapping of a file.
+*/
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/* Maps a whole file into memory for reading, unmapped again on destruction */
+class MappedFile
+{
+public:
+    // Maps the file, throws if it can't be opened
+    explicit MappedFile( const std::string& filePath );
+    ~MappedFile();
+
+    MappedFile( const MappedFile& ) = delete;
+    MappedFile& operator=( const MappedFile& ) = delete;
+
+    // File contents
+    const char* begin() const;
+    const char* end() const;
+    std::size_t size() const;
+
+    // Drops the pages before position from memory, they are read again if touched
+    void release( const char* position );
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t released_ = 0; // bytes at the start of the file that were released
+};
+
+#endif // MAPPED_FILE_H
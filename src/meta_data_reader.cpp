@@ -0,0 +1,315 @@
+#include "meta_data_reader.h"
+
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+    // Parsed pages are released once this much of the file was read past them
+    const std::ptrdiff_t RELEASE_SIZE = 16 << 20;
+
+    // Integer with an optional sign, false if the range holds anything else
+    bool parse_integer( const char* begin, const char* end, int& value )
+    {
+        bool negative = begin != end && *begin == '-';
+        if( negative )
+        {
+            begin++;
+        }
+        if( begin == end )
+        {
+            return false;
+        }
+
+        long long result = 0;
+        for( ; begin != end; begin++ )
+        {
+            if( *begin < '0' || *begin > '9' || result > std::numeric_limits<int>::max() )
+            {
+                return false;
+            }
+            result = result * 10 + ( *begin - '0' );
+        }
+        if( result > std::numeric_limits<int>::max() )
+        {
+            return false;
+        }
+        value = static_cast<int>( negative ? -result : result );
+        return true;
+    }
+}
+
+/* Constructor for the MetaDataReader class
+* @param filePath = meta-data file to read
+* @except Throws exception if the file can't be opened or doesn't start correctly
+*/
+MetaDataReader::MetaDataReader( const std::string& filePath )
+    : file_( filePath ), position_( file_.begin() ), released_( file_.begin() )
+{
+    // make sure the beginning of the file is correct
+    Token start = next_token( ';' );
+    skip_whitespace();
+    if( start != "Start Program Meta-Data Code:\nS(start)0" )
+    {
+        throw std::runtime_error( "Error: Incorrect meta-data file format: \
+            Simulator start flag is missing\n" );
+    }
+}
+
+/* Read every operation of the next program
+* @param operations = cleared, then filled with the program's operations
+* @param attributes = reset, then filled from the program's A(start)
+* @return false if there are no more programs
+* @except Throws exception if the file format isn't correct
+*/
+bool MetaDataReader::next_program( std::vector<Operation>& operations, ProgramAttributes& attributes )
+{
+    operations.clear();
+    attributes = ProgramAttributes();
+
+    // programs are only read once, so the memory they were mapped into can go
+    if( position_ - released_ >= RELEASE_SIZE )
+    {
+        file_.release( position_ );
+        released_ = position_;
+    }
+
+    if( position_ == file_.end() )
+    {
+        throw std::runtime_error( "Error: Incorrect meta-data file format: \
+            Simulator end flag is missing\n" );
+    }
+
+    if( *position_ == 'S' )
+    {
+        // Make sure the simulator end flag is there
+        Token end = next_token( '.' );
+        skip_whitespace();
+        if( end != "S(end)0" )
+        {
+            throw std::runtime_error( "Error: Incorrect meta-data file format: \
+            Simulator end flag is missing\n" );
+        }
+
+        // make sure the last line of the file is correct
+        Token last = next_token( '.' );
+        if( last != "End Program Meta-Data Code" )
+        {
+            throw std::runtime_error( "Error: Incorrect meta-data file format: \
+            Meta-Data file does not end after simulator operations end\n" );
+        }
+        return false;
+    }
+
+    // Get all program data
+    Operation operation;
+    Token input;
+    do
+    {
+        if( position_ == file_.end() )
+        {
+            throw std::runtime_error( "Error: Incorrect meta-data file format: \
+            Simulator end flag is missing\n" );
+        }
+
+        // token looks like this: "A(start)0"
+        input = next_token( ';' );
+        parse_operation( input, operation, attributes );
+        operations.push_back( operation );
+
+        // eat whitespace
+        skip_whitespace();
+    } while( input != "A(end)0" );
+
+    return true;
+}
+
+/* Token comparison with a C string
+*/
+bool MetaDataReader::Token::operator==( const char* text ) const
+{
+    std::size_t length = std::strlen( text );
+    return std::size_t( end - begin ) == length && std::memcmp( begin, text, length ) == 0;
+}
+
+/* Take the characters up to the delimiter and move past it
+* @param delimiter = character that ends the token
+* @return the token, without the delimiter
+*/
+MetaDataReader::Token MetaDataReader::next_token( const char delimiter )
+{
+    Token token;
+    token.begin = position_;
+    const void* found = std::memchr( position_, delimiter, file_.end() - position_ );
+    token.end = found ? static_cast<const char*>( found ) : file_.end();
+    position_ = found ? token.end + 1 : file_.end();
+    return token;
+}
+
+/* Move past any whitespace
+*/
+void MetaDataReader::skip_whitespace()
+{
+    while( position_ != file_.end() && std::isspace( static_cast<unsigned char>( *position_ ) ) )
+    {
+        position_++;
+    }
+}
+
+/* Parse an operation token in place
+* @param token = text such as "P(run)11", "A(start arrival=50)0" or "I(hard drive block=7)3"
+* @param operation = receives type, description and cycles
+* @param attributes = receives the program attributes, if the token has any
+* @except Throws exception if the token isn't a well formed operation
+*/
+void MetaDataReader::parse_operation( const Token& token, Operation& operation, 
+    ProgramAttributes& attributes )
+{
+    const char* paranthesis = static_cast<const char*>(
+        std::memchr( token.begin, ')', token.end - token.begin ) );
+    if( paranthesis == nullptr || paranthesis - token.begin < 2 || token.begin[1] != '(' )
+    {
+        throw std::runtime_error( "Error: Incorrect meta-data file format: malformed operation " + 
+            std::string( token.begin, token.end ) + "\n" );
+    }
+
+    // parsing Operation object, the description ends at the first attribute
+    const char* description = token.begin + 2;
+    const char* descriptionEnd = description;
+    while( descriptionEnd != paranthesis && *descriptionEnd != '=' )
+    {
+        descriptionEnd++;
+    }
+    if( descriptionEnd != paranthesis )
+    {
+        while( descriptionEnd != description && *descriptionEnd != ' ' )
+        {
+            descriptionEnd--;
+        }
+    }
+    operation.type = token.begin[0];
+    operation.set_description( description, descriptionEnd - description );
+    operation.block = -1;
+    parse_attributes( token, descriptionEnd, paranthesis, operation, attributes );
+
+    // cycle count, digits with optional surrounding whitespace
+    const char* digit = paranthesis + 1;
+    while( digit != token.end && std::isspace( static_cast<unsigned char>( *digit ) ) )
+    {
+        digit++;
+    }
+    const char* digitsStart = digit;
+    long long cycles = 0;
+    while( digit != token.end && *digit >= '0' && *digit <= '9' )
+    {
+        cycles = cycles * 10 + ( *digit - '0' );
+        if( cycles > std::numeric_limits<int>::max() )
+        {
+            break;
+        }
+        digit++;
+    }
+    const char* digitsEnd = digit;
+    while( digit != token.end && std::isspace( static_cast<unsigned char>( *digit ) ) )
+    {
+        digit++;
+    }
+    if( digitsStart == digitsEnd || digit != token.end )
+    {
+        throw std::runtime_error( "Error: Incorrect meta-data file format: invalid cycle count in " + 
+            std::string( token.begin, token.end ) + "\n" );
+    }
+    operation.cycles = static_cast<int>( cycles );
+}
+
+/* Parse space separated name=value pairs
+* @param token = whole operation, for error messages
+* @param begin = first character after the description
+* @param end = closing paranthesis
+* @param operation = operation the attributes belong to, its description is already set.
+* Receives the block of a hard drive operation
+* @param attributes = receives the values
+* @except Throws exception on unknown names, bad values, or attributes where none belong
+*/
+void MetaDataReader::parse_attributes( const Token& token, const char* begin, const char* end,
+    Operation& operation, ProgramAttributes& attributes )
+{
+    while( true )
+    {
+        while( begin != end && *begin == ' ' )
+        {
+            begin++;
+        }
+        if( begin == end )
+        {
+            // only periodic programs are released more than once
+            if( attributes.jobs > 1 && attributes.period == 0 )
+            {
+                invalid_attribute( token );
+            }
+            return;
+        }
+
+        const char* nameEnd = begin;
+        while( nameEnd != end && *nameEnd != '=' )
+        {
+            nameEnd++;
+        }
+        const char* valueEnd = nameEnd;
+        while( valueEnd != end && *valueEnd != ' ' )
+        {
+            valueEnd++;
+        }
+
+        int value;
+        Token name = { begin, nameEnd };
+        if( nameEnd == end || !parse_integer( nameEnd + 1, valueEnd, value ) )
+        {
+            invalid_attribute( token );
+        }
+
+        // program attributes only belong on the program's start
+        bool programStart = operation.type == 'A' && operation.opcode == OP_START;
+        if( programStart && name == "arrival" && value >= 0 )
+        {
+            attributes.arrival = value;
+        }
+        else if( programStart && name == "nice" && value >= -20 && value <= 19 )
+        {
+            attributes.nice = value;
+        }
+        else if( programStart && name == "period" && value > 0 )
+        {
+            attributes.period = value;
+        }
+        else if( programStart && name == "deadline" && value > 0 )
+        {
+            attributes.deadline = value;
+        }
+        else if( programStart && name == "jobs" && value > 0 )
+        {
+            attributes.jobs = value;
+        }
+        else if( operation.device == HARD_DRIVE && name == "block" && value >= 0 )
+        {
+            operation.block = value;
+        }
+        else
+        {
+            invalid_attribute( token );
+        }
+        begin = valueEnd;
+    }
+}
+
+/* Report an attribute that is unknown, malformed or out of place
+* @param token = whole operation the attribute is in
+* @except Always throws
+*/
+void MetaDataReader::invalid_attribute( const Token& token )
+{
+    throw std::runtime_error( "Error: Incorrect meta-data file format: invalid attribute in " + 
+        std::string( token.begin, token.end ) + "\n" );
+}
@@ -0,0 +1,63 @@
+/*
+* Filename: meta_data_reader.h
+* Specifications for the MetaDataReader object, which parses a meta-data file
+* one program at a time.
+*/
+
+#ifndef META_DATA_READER_H
+#define META_DATA_READER_H
+
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+#include "operation.h"
+#include "program.h"
+
+/* Parses a memory mapped meta-data file in place. Tokens are only ever pointer ranges
+* into the mapping, so reading an operation doesn't allocate. Cycle times are left to
+* the caller, they come from the config file. */
+class MetaDataReader
+{
+public:
+    // Maps the file and checks the simulator start flag
+    explicit MetaDataReader( const std::string& filePath );
+
+    // Reads the next program's operations, from A(start) to A(end) inclusive, and the
+    // attributes given in its A(start). Returns false once the simulator end flag was
+    // reached and the rest of the file was checked
+    bool next_program( std::vector<Operation>& operations, ProgramAttributes& attributes );
+
+private:
+    // Range of characters up to (not including) the delimiter, which is skipped.
+    // Runs to the end of the file if the delimiter is missing
+    struct Token
+    {
+        const char* begin;
+        const char* end;
+        bool operator==( const char* text ) const;
+        bool operator!=( const char* text ) const { return !(*this == text); }
+    };
+    Token next_token( const char delimiter );
+
+    // Same as fin >> std::ws
+    void skip_whitespace();
+
+    // Turns a token such as "I(hard drive)14" into an operation
+    void parse_operation( const Token& token, Operation& operation, ProgramAttributes& attributes );
+
+    // Reads the "name=value" pairs following a description, program attributes or the
+    // block of a hard drive operation
+    void parse_attributes( const Token& token, const char* begin, const char* end,
+        Operation& operation, ProgramAttributes& attributes );
+
+    // Throws the error for a bad attribute in the given operation. The message is only
+    // built here, so parsing operations without attributes doesn't allocate
+    [[noreturn]] static void invalid_attribute( const Token& token );
+
+    MappedFile file_;
+    const char* position_;
+    const char* released_; // pages before this were handed back to the OS
+};
+
+#endif // META_DATA_READER_H
@@ -0,0 +1,276 @@
+#include "metrics.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+namespace
+{
+    // msec with microsecond precision, the resolution of the log
+    std::string msec( const std::chrono::nanoseconds time )
+    {
+        char buffer[32];
+        std::snprintf( buffer, sizeof(buffer), "%.3f", time.count() / 1e6 );
+        return buffer;
+    }
+
+    std::string ratio( const double value )
+    {
+        char buffer[32];
+        std::snprintf( buffer, sizeof(buffer), "%.4f", value );
+        return buffer;
+    }
+
+    // Mean, percentiles and maximum of one quantity over every job
+    struct Distribution
+    {
+        explicit Distribution( std::vector<std::chrono::nanoseconds> values )
+        {
+            std::sort( values.begin(), values.end() );
+            std::chrono::nanoseconds total{ 0 };
+            for( const std::chrono::nanoseconds value : values )
+            {
+                total += value;
+            }
+            count = values.size();
+            if( count > 0 )
+            {
+                mean = total / static_cast<long long>( count );
+                p50 = percentile( values, 50 );
+                p90 = percentile( values, 90 );
+                p99 = percentile( values, 99 );
+                max = values.back();
+            }
+        }
+
+        // nearest rank, values have to be sorted and not empty
+        static std::chrono::nanoseconds percentile( const std::vector<std::chrono::nanoseconds>& values,
+            const int percent )
+        {
+            std::size_t rank = ( values.size() * percent + 99 ) / 100;
+            return values[ std::max<std::size_t>( rank, 1 ) - 1 ];
+        }
+
+        std::size_t count = 0;
+        std::chrono::nanoseconds mean{ 0 }, p50{ 0 }, p90{ 0 }, p99{ 0 }, max{ 0 };
+    };
+
+    // Statistics names in output order, with the Distribution member they come from
+    const char* const STATISTICS[] = { "mean", "p50", "p90", "p99", "max" };
+    std::chrono::nanoseconds statistic( const Distribution& distribution, const int index )
+    {
+        const std::chrono::nanoseconds values[] = { distribution.mean, distribution.p50,
+            distribution.p90, distribution.p99, distribution.max };
+        return values[index];
+    }
+}
+
+/* Constructor for the MetricsCollector class
+* @param cpus = number of recording threads, each gets a shard
+*/
+MetricsCollector::MetricsCollector( const int cpus ) : shards_( cpus )
+{
+}
+
+/* Record a finished job
+* @param cpu = CPU the job exited on, counting from 0
+* @param program = program whose job exited
+* @param finish = time it exited
+*/
+void MetricsCollector::job_finished( const int cpu, const Program& program,
+    const std::chrono::nanoseconds finish )
+{
+    const ProgramMetrics &metrics = program.metrics;
+    Job job = { program.id, metrics.arrival, metrics.firstRun, finish,
+        metrics.ready, metrics.running, metrics.blocked, metrics.dispatches };
+    shards_[cpu].jobs.push_back( job );
+}
+
+/* Record an I/O operation
+* @param cpu = shard of the thread that started the operation, the CPUs count from 0
+* @param device = device the operation uses
+* @param requested = when the operation was asked for, it waited for a channel until start
+* @param start, end = when the device was busy
+*/
+void MetricsCollector::io( const int cpu, const Device device, const std::chrono::nanoseconds requested,
+    const std::chrono::nanoseconds start, const std::chrono::nanoseconds end )
+{
+    Interval interval = { requested, start, end, device };
+    shards_[cpu].io.push_back( interval );
+}
+
+/* Write the metrics. Turnaround is the time from arrival to exit, waiting the time spent
+* in a ready queue and response the time until the first run. A device is busy while at
+* least one of its operations runs, the mean depth of its queue is the time operations
+* waited for a channel over the length of the run
+* @param out = stream to write to
+* @param format = JSON, or CSV with a row per process, a blank line and a row per total
+* @param elapsed = length of the run
+* @param cpus = number of simulated CPUs
+* @param busyTime = time the CPUs were busy, summed over every CPU
+*/
+void MetricsCollector::write( std::ostream& out, const Format format, const std::chrono::nanoseconds elapsed,
+    const int cpus, const std::chrono::nanoseconds busyTime ) const
+{
+    std::vector<Job> jobs;
+    std::vector<Interval> intervals;
+    for( const Shard &shard : shards_ )
+    {
+        jobs.insert( jobs.end(), shard.jobs.begin(), shard.jobs.end() );
+        intervals.insert( intervals.end(), shard.io.begin(), shard.io.end() );
+    }
+    std::sort( jobs.begin(), jobs.end(), []( const Job& left, const Job& right ){
+        return left.id < right.id;
+    });
+
+    std::vector<std::chrono::nanoseconds> turnaround, waiting, response;
+    for( const Job &job : jobs )
+    {
+        turnaround.push_back( job.finish - job.arrival );
+        waiting.push_back( job.ready );
+        response.push_back( ( job.firstRun.count() < 0 ? job.finish : job.firstRun ) - job.arrival );
+    }
+    const char* const distributionNames[] = { "turnaround", "waiting", "response" };
+    const Distribution distributions[] = { Distribution( turnaround ), Distribution( waiting ),
+        Distribution( response ) };
+
+    // busy time of every device, overlapping operations only count once
+    std::sort( intervals.begin(), intervals.end(), []( const Interval& left, const Interval& right ){
+        return left.start < right.start;
+    });
+    std::chrono::nanoseconds deviceBusy[DEVICE_COUNT] = {};
+    std::chrono::nanoseconds deviceEnd[DEVICE_COUNT] = {};
+    unsigned long long deviceOperations[DEVICE_COUNT] = {};
+    std::chrono::nanoseconds deviceWait[DEVICE_COUNT] = {};
+    std::chrono::nanoseconds deviceMaxWait[DEVICE_COUNT] = {};
+    for( const Interval &interval : intervals )
+    {
+        const std::chrono::nanoseconds wait = interval.start - interval.requested;
+        deviceWait[interval.device] += wait;
+        deviceMaxWait[interval.device] = std::max( deviceMaxWait[interval.device], wait );
+        const std::chrono::nanoseconds start = std::max( interval.start, deviceEnd[interval.device] );
+        if( interval.end > start )
+        {
+            deviceBusy[interval.device] += interval.end - start;
+            deviceEnd[interval.device] = interval.end;
+        }
+        deviceOperations[interval.device]++;
+    }
+
+    const double seconds = std::chrono::duration<double>( elapsed ).count();
+    const double utilization = elapsed.count() > 0 ?
+        static_cast<double>( busyTime.count() ) / ( elapsed.count() * static_cast<double>( cpus ) ) : 0.0;
+    const double throughput = seconds > 0 ? jobs.size() / seconds : 0.0;
+    auto device_utilization = [&]( const int device ){
+        return elapsed.count() > 0 ? static_cast<double>( deviceBusy[device].count() ) / elapsed.count() : 0.0;
+    };
+    auto device_mean_wait = [&]( const int device ){
+        return deviceOperations[device] > 0 ? 
+            std::chrono::nanoseconds( deviceWait[device].count() / static_cast<long long>( deviceOperations[device] ) ) :
+            std::chrono::nanoseconds( 0 );
+    };
+    auto device_queue_depth = [&]( const int device ){
+        return elapsed.count() > 0 ? static_cast<double>( deviceWait[device].count() ) / elapsed.count() : 0.0;
+    };
+
+    std::string text;
+    if( format == CSV )
+    {
+        text += "pid,arrival_ms,first_run_ms,finish_ms,turnaround_ms,waiting_ms,response_ms,"
+            "cpu_ms,io_ms,dispatches\n";
+        for( std::size_t i = 0; i < jobs.size(); i++ )
+        {
+            const Job &job = jobs[i];
+            text.append( std::to_string( job.id ) ).append( "," )
+                .append( msec( job.arrival ) ).append( "," )
+                .append( job.firstRun.count() < 0 ? "" : msec( job.firstRun ) ).append( "," )
+                .append( msec( job.finish ) ).append( "," )
+                .append( msec( turnaround[i] ) ).append( "," )
+                .append( msec( waiting[i] ) ).append( "," )
+                .append( msec( response[i] ) ).append( "," )
+                .append( msec( job.running ) ).append( "," )
+                .append( msec( job.blocked ) ).append( "," )
+                .append( std::to_string( job.dispatches ) ).append( "\n" );
+        }
+
+        text += "\nmetric,value\n";
+        text.append( "processes," ).append( std::to_string( jobs.size() ) ).append( "\n" );
+        text.append( "elapsed_ms," ).append( msec( elapsed ) ).append( "\n" );
+        text.append( "cpus," ).append( std::to_string( cpus ) ).append( "\n" );
+        text.append( "cpu_utilization," ).append( ratio( utilization ) ).append( "\n" );
+        text.append( "throughput_per_sec," ).append( ratio( throughput ) ).append( "\n" );
+        for( int d = 0; d < 3; d++ )
+        {
+            for( int s = 0; s < 5; s++ )
+            {
+                text.append( distributionNames[d] ).append( "_" ).append( STATISTICS[s] ).append( "_ms," )
+                    .append( msec( statistic( distributions[d], s ) ) ).append( "\n" );
+            }
+        }
+        for( int device = HARD_DRIVE; device < DEVICE_COUNT; device++ )
+        {
+            std::string name = device_name( static_cast<Device>( device ) );
+            std::replace( name.begin(), name.end(), ' ', '_' );
+            text.append( name ).append( "_operations," )
+                .append( std::to_string( deviceOperations[device] ) ).append( "\n" );
+            text.append( name ).append( "_busy_ms," ).append( msec( deviceBusy[device] ) ).append( "\n" );
+            text.append( name ).append( "_utilization," )
+                .append( ratio( device_utilization( device ) ) ).append( "\n" );
+            text.append( name ).append( "_wait_mean_ms," ).append( msec( device_mean_wait( device ) ) ).append( "\n" );
+            text.append( name ).append( "_wait_max_ms," ).append( msec( deviceMaxWait[device] ) ).append( "\n" );
+            text.append( name ).append( "_queue_depth," )
+                .append( ratio( device_queue_depth( device ) ) ).append( "\n" );
+        }
+    }
+    else
+    {
+        text += "{\n  \"processes\": [";
+        for( std::size_t i = 0; i < jobs.size(); i++ )
+        {
+            const Job &job = jobs[i];
+            text.append( i == 0 ? "\n" : ",\n" )
+                .append( "    {\"pid\": " ).append( std::to_string( job.id ) )
+                .append( ", \"arrival_ms\": " ).append( msec( job.arrival ) )
+                .append( ", \"first_run_ms\": " ).append( job.firstRun.count() < 0 ? "null" : msec( job.firstRun ) )
+                .append( ", \"finish_ms\": " ).append( msec( job.finish ) )
+                .append( ", \"turnaround_ms\": " ).append( msec( turnaround[i] ) )
+                .append( ", \"waiting_ms\": " ).append( msec( waiting[i] ) )
+                .append( ", \"response_ms\": " ).append( msec( response[i] ) )
+                .append( ", \"cpu_ms\": " ).append( msec( job.running ) )
+                .append( ", \"io_ms\": " ).append( msec( job.blocked ) )
+                .append( ", \"dispatches\": " ).append( std::to_string( job.dispatches ) ).append( "}" );
+        }
+        text += jobs.empty() ? "],\n" : "\n  ],\n";
+
+        text.append( "  \"system\": {\n" )
+            .append( "    \"processes\": " ).append( std::to_string( jobs.size() ) ).append( ",\n" )
+            .append( "    \"elapsed_ms\": " ).append( msec( elapsed ) ).append( ",\n" )
+            .append( "    \"cpus\": " ).append( std::to_string( cpus ) ).append( ",\n" )
+            .append( "    \"cpu_utilization\": " ).append( ratio( utilization ) ).append( ",\n" )
+            .append( "    \"throughput_per_sec\": " ).append( ratio( throughput ) ).append( ",\n" );
+        for( int d = 0; d < 3; d++ )
+        {
+            text.append( "    \"" ).append( distributionNames[d] ).append( "_ms\": {" );
+            for( int s = 0; s < 5; s++ )
+            {
+                text.append( s == 0 ? "\"" : ", \"" ).append( STATISTICS[s] ).append( "\": " )
+                    .append( msec( statistic( distributions[d], s ) ) );
+            }
+            text += "},\n";
+        }
+        text += "    \"devices\": {";
+        for( int device = HARD_DRIVE; device < DEVICE_COUNT; device++ )
+        {
+            text.append( device == HARD_DRIVE ? "\n" : ",\n" )
+                .append( "      \"" ).append( device_name( static_cast<Device>( device ) ) ).append( "\": {" )
+                .append( "\"operations\": " ).append( std::to_string( deviceOperations[device] ) )
+                .append( ", \"busy_ms\": " ).append( msec( deviceBusy[device] ) )
+                .append( ", \"utilization\": " ).append( ratio( device_utilization( device ) ) )
+                .append( ", \"wait_mean_ms\": " ).append( msec( device_mean_wait( device ) ) )
+                .append( ", \"wait_max_ms\": " ).append( msec( deviceMaxWait[device] ) )
+                .append( ", \"queue_depth\": " ).append( ratio( device_queue_depth( device ) ) ).append( "}" );
+        }
+        text += "\n    }\n  }\n}\n";
+    }
+    out << text;
+}
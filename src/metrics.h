@@ -0,0 +1,70 @@
+/*
+* Filename: metrics.h
+* Specifications for the MetricsCollector object, per-process and system statistics of a run.
+*/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+#include "device.h"
+#include "program.h"
+
+/* Collects what every job went through and when every device was busy, and reports
+* turnaround, waiting and response times, utilization and throughput at the end. Every
+* simulated CPU records into a shard of its own, so recording needs no locks */
+class MetricsCollector
+{
+public:
+    enum Format
+    {
+        JSON, CSV
+    };
+
+    explicit MetricsCollector( const int cpus );
+
+    // A job of a program exited, its metrics are copied
+    void job_finished( const int cpu, const Program& program, const std::chrono::nanoseconds finish );
+
+    // An I/O operation asked for at requested started, it keeps the device busy until end.
+    // cpu is the shard of the recording thread, a CPU or the I/O thread after them
+    void io( const int cpu, const Device device, const std::chrono::nanoseconds requested,
+        const std::chrono::nanoseconds start, const std::chrono::nanoseconds end );
+
+    // Writes a row per process followed by the totals of the run
+    // @param elapsed = length of the run
+    // @param busyTime = time the CPUs were busy, summed over every CPU
+    void write( std::ostream& out, const Format format, const std::chrono::nanoseconds elapsed,
+        const int cpus, const std::chrono::nanoseconds busyTime ) const;
+
+private:
+    struct Job
+    {
+        int id;
+        std::chrono::nanoseconds arrival;
+        std::chrono::nanoseconds firstRun;
+        std::chrono::nanoseconds finish;
+        std::chrono::nanoseconds ready;
+        std::chrono::nanoseconds running;
+        std::chrono::nanoseconds blocked;
+        int dispatches;
+    };
+    struct Interval
+    {
+        std::chrono::nanoseconds requested;
+        std::chrono::nanoseconds start;
+        std::chrono::nanoseconds end;
+        Device device;
+    };
+    struct Shard
+    {
+        std::vector<Job> jobs;
+        std::vector<Interval> io;
+    };
+    std::vector<Shard> shards_;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,173 @@
+#include "mlfq_scheduler.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    const char* const LEVELS_SETTING = "MLFQ Levels";
+    const char* const QUANTA_SETTING = "MLFQ Quanta (cycles)";
+    const char* const BOOST_SETTING = "MLFQ Boost Period (msec)";
+
+    const int DEFAULT_LEVELS = 3;
+    const int DEFAULT_BOOST_PERIOD = 1000;
+}
+
+/* Constructor for the MLFQScheduler class
+* Without settings there are 3 levels, the quantum doubles with every level starting at
+* the config's quantum, and programs are boosted every second
+* @param settings = PCB table, config values and the MLFQ settings
+* @except Throws exception if the MLFQ settings are invalid
+*/
+MLFQScheduler::MLFQScheduler( const SchedulerSettings& settings ) 
+    : Scheduler( settings ), boostPeriod_( DEFAULT_BOOST_PERIOD )
+{
+    const auto &options = settings.options;
+    auto levels = options.find( LEVELS_SETTING );
+    auto quanta = options.find( QUANTA_SETTING );
+    auto boost = options.find( BOOST_SETTING );
+
+    // quanta are a comma separated list, one per level
+    if( quanta != options.end() )
+    {
+        std::istringstream list( quanta->second );
+        std::string quantum;
+        while( std::getline( list, quantum, ',' ) )
+        {
+            quantum.erase( 0, quantum.find_first_not_of( " \t" ) );
+            quantum.erase( quantum.find_last_not_of( " \t" ) + 1 );
+            quanta_.push_back( positive_setting( quantum, "Error: MLFQ quanta must be positive\n" ) );
+        }
+    }
+
+    int levelCount = quanta_.empty() ? DEFAULT_LEVELS : static_cast<int>( quanta_.size() );
+    if( levels != options.end() )
+    {
+        levelCount = positive_setting( levels->second, "Error: MLFQ levels must be positive\n" );
+    }
+    if( quanta_.empty() )
+    {
+        for( int level = 0; level < levelCount; level++ )
+        {
+            quanta_.push_back( std::max( 1, settings.quantum ) << std::min( level, 20 ) );
+        }
+    }
+    else if( static_cast<int>( quanta_.size() ) != levelCount )
+    {
+        throw std::runtime_error( "Error: MLFQ needs one quantum per level\n" );
+    }
+    levels_.resize( levelCount );
+
+    if( boost != options.end() )
+    {
+        boostPeriod_ = std::chrono::milliseconds( 
+            positive_setting( boost->second, "Error: MLFQ boost period must be positive\n" ) );
+    }
+}
+
+/* Optional config settings
+*/
+std::vector<std::string> MLFQScheduler::setting_names()
+{
+    return { LEVELS_SETTING, QUANTA_SETTING, BOOST_SETTING };
+}
+
+/* Queue a program at its level. One that hasn't been here since the last boost
+* missed it, so it starts over at the top
+*/
+void MLFQScheduler::push( const int programIndex )
+{
+    Program &program = programs_[programIndex];
+    if( program.scheduling.boost < boost_ )
+    {
+        reset( program );
+    }
+    levels_[program.scheduling.level].push_back( programIndex );
+    size_++;
+}
+
+/* Take the first program of the highest level that has one
+*/
+int MLFQScheduler::pop()
+{
+    for( std::deque<int> &level : levels_ )
+    {
+        if( !level.empty() )
+        {
+            int nextProgram = level.front();
+            level.pop_front();
+            size_--;
+            return nextProgram;
+        }
+    }
+    throw std::logic_error( "MLFQ queue is empty" );
+}
+
+bool MLFQScheduler::empty() const
+{
+    return size_ == 0;
+}
+
+/* The quantum of the program's level
+*/
+int MLFQScheduler::quantum( const int programIndex ) const
+{
+    return quanta_[programs_[programIndex].scheduling.level];
+}
+
+/* Charge the program for its time at the level, once its allotment is used up it
+* moves down a level. Giving up the CPU early doesn't reset the allotment, so a
+* program can't stay on top by blocking just before its quantum expires
+* @param programIndex = program that ran
+* @param time = usec it ran
+*/
+void MLFQScheduler::ran( const int programIndex, const long long time )
+{
+    Program &program = programs_[programIndex];
+    SchedulingState &state = program.scheduling;
+    state.levelTime += time;
+    const long long allotment = static_cast<long long>( quanta_[state.level] ) * settings_.processorCycleTime;
+    if( state.levelTime >= allotment && state.level + 1 < static_cast<int>( levels_.size() ) )
+    {
+        state.level++;
+        state.levelTime = 0;
+    }
+}
+
+/* Boost every queued program to the highest level once a boost period passed
+* @param now = time of the CPU
+*/
+void MLFQScheduler::update( const std::chrono::nanoseconds now )
+{
+    const long long boost = now / boostPeriod_;
+    if( boost <= boost_ )
+    {
+        return;
+    }
+    boost_ = boost;
+
+    std::deque<int> &top = levels_[0];
+    for( int program : top )
+    {
+        reset( programs_[program] );
+    }
+    for( std::size_t level = 1; level < levels_.size(); level++ )
+    {
+        for( int program : levels_[level] )
+        {
+            reset( programs_[program] );
+            top.push_back( program );
+        }
+        levels_[level].clear();
+    }
+}
+
+/* Moves a program to the top level
+*/
+void MLFQScheduler::reset( Program &program ) const
+{
+    program.scheduling.level = 0;
+    program.scheduling.levelTime = 0;
+    program.scheduling.boost = boost_;
+}
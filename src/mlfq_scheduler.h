@@ -0,0 +1,45 @@
+/*
+* Filename: mlfq_scheduler.h
+* Specifications for the Multi-Level Feedback Queue scheduling policy.
+*/
+
+#ifndef MLFQ_SCHEDULER_H
+#define MLFQ_SCHEDULER_H
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "scheduler.h"
+
+/* Multi-Level Feedback Queue. Programs start in the highest level and move down a level
+* once they used up the time allotted at their level, so long CPU bursts sink while
+* programs that block for I/O stay on top. Each level is round robin with a quantum of
+* its own. Every boost period all programs go back to the highest level, so nothing starves */
+class MLFQScheduler final : public Scheduler
+{
+public:
+    explicit MLFQScheduler( const SchedulerSettings& settings );
+
+    // Names of the optional config settings this policy reads
+    static std::vector<std::string> setting_names();
+
+    void push( const int programIndex ) override;
+    int pop() override;
+    bool empty() const override;
+    int quantum( const int programIndex ) const override;
+    void ran( const int programIndex, const long long time ) override;
+    void update( const std::chrono::nanoseconds now ) override;
+
+private:
+    // Moves a program to the highest level, with nothing used up
+    void reset( Program &program ) const;
+
+    std::vector<std::deque<int>> levels_; // ready programs of every level, 0 runs first
+    std::vector<int> quanta_; // cycles, also the time allotted at the level
+    std::chrono::milliseconds boostPeriod_;
+    long long boost_ = 0; // number of boosts so far
+    std::size_t size_ = 0;
+};
+
+#endif // MLFQ_SCHEDULER_H
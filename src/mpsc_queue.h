@@ -0,0 +1,151 @@
+/*
+* Filename: mpsc_queue.h
+* Specifications for the MPSCQueue object. Lock-free multi-producer single-consumer
+* queue whose consumer can block until something is pushed.
+*/
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+/* Unbounded linked queue (Vyukov's MPSC algorithm). Any thread may push, pushing
+* is a single atomic exchange. Only one thread may pop, wait or check empty. */
+template<typename T>
+class MPSCQueue
+{
+public:
+    MPSCQueue() : head_( &stub_ ), tail_( &stub_ ) {}
+    ~MPSCQueue();
+
+    MPSCQueue( const MPSCQueue& ) = delete;
+    MPSCQueue& operator=( const MPSCQueue& ) = delete;
+
+    // Producers: add a value, waking the consumer if it is blocked
+    void push( const T& value );
+
+    // Consumer: take the oldest value, false if the queue is empty
+    bool try_pop( T& value );
+
+    // Consumer: true if nothing is ready to be popped
+    bool empty() const;
+
+    // Consumer: block until something can be popped
+    void wait();
+
+    // Consumer: block until something can be popped or the deadline passes
+    template<typename Clock, typename Duration>
+    void wait_until( const std::chrono::time_point<Clock, Duration>& deadline );
+
+private:
+    struct Node
+    {
+        std::atomic<Node*> next{ nullptr };
+        T value;
+    };
+
+    Node stub_; // dummy node, the queue always contains at least one node
+    std::atomic<Node*> head_; // most recently pushed node, shared by producers
+    Node* tail_; // node before the oldest value, owned by the consumer
+
+    // Blocking wakeup, producers only touch the mutex when the consumer is asleep
+    std::atomic<bool> sleeping_{ false };
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+};
+
+template<typename T>
+MPSCQueue<T>::~MPSCQueue()
+{
+    T value;
+    while( try_pop( value ) );
+    if( tail_ != &stub_ )
+    {
+        delete tail_;
+    }
+}
+
+/* Add a value to the queue
+* The new node becomes the head in one exchange, and is then linked behind the old
+* head. The consumer sees the value as soon as that link is stored.
+* @param value to push
+*/
+template<typename T>
+void MPSCQueue<T>::push( const T& value )
+{
+    Node* node = new Node;
+    node->value = value;
+    Node* previous = head_.exchange( node, std::memory_order_acq_rel );
+    previous->next.store( node, std::memory_order_release );
+
+    // pairs with the fence in wait(), either the consumer sees the node or we see it sleeping
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    if( sleeping_.load( std::memory_order_relaxed ) )
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        wakeup_.notify_one();
+    }
+}
+
+/* Take the oldest value out of the queue
+* @param value = receives the popped value
+* @return true if a value was popped
+*/
+template<typename T>
+bool MPSCQueue<T>::try_pop( T& value )
+{
+    Node* tail = tail_;
+    Node* next = tail->next.load( std::memory_order_acquire );
+    if( next == nullptr )
+    {
+        return false;
+    }
+
+    // next becomes the new dummy node, its value is no longer needed
+    value = next->value;
+    tail_ = next;
+    if( tail != &stub_ )
+    {
+        delete tail;
+    }
+    return true;
+}
+
+/* Nothing to pop? A push that is still being linked counts as empty
+*/
+template<typename T>
+bool MPSCQueue<T>::empty() const
+{
+    return tail_->next.load( std::memory_order_acquire ) == nullptr;
+}
+
+/* Block until a value is ready, returns immediately if one already is
+*/
+template<typename T>
+void MPSCQueue<T>::wait()
+{
+    std::unique_lock<std::mutex> lock( mutex_ );
+    sleeping_.store( true, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    wakeup_.wait( lock, [this](){ return !empty(); } );
+    sleeping_.store( false, std::memory_order_relaxed );
+}
+
+/* Block until a value is ready or the deadline passed
+* @param deadline = latest point in time to return at
+*/
+template<typename T>
+template<typename Clock, typename Duration>
+void MPSCQueue<T>::wait_until( const std::chrono::time_point<Clock, Duration>& deadline )
+{
+    std::unique_lock<std::mutex> lock( mutex_ );
+    sleeping_.store( true, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    wakeup_.wait_until( lock, deadline, [this](){ return !empty(); } );
+    sleeping_.store( false, std::memory_order_relaxed );
+}
+
+#endif // MPSC_QUEUE_H
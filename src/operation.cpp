@@ -1,15 +1,20 @@
 #include "operation.h"
 
+#include <cstring>
+#include <stdexcept>
+#include <string>
 
-/* Run a single cycle
-* Decrements duration by cycle_time and cycle by one
-* @return cycle time so operating system knows how long its going to run for
+
+/* Run cycles of the operation
+* Decrements cycles by one for every cycle
+* @param count = cycles to run, no more than are left
+* @param cycleTime = usec per cycle, as CycleTimes gives it for the operation
+* @return time in usec so operating system knows how long its going to run for
 */ 
-int Operation::run()
+long long Operation::run( const int count, const int cycleTime )
 {
-    duration -= cycleTime;
-    cycles--;
-    return cycleTime;
+    cycles -= count;
+    return static_cast<long long>( cycleTime ) * count;
 }
 
 /* Operation done executing?
@@ -18,4 +23,74 @@ int Operation::run()
 bool Operation::done()
 {
     return cycles == 0;
-}
\ No newline at end of file
+}
+
+/* Intern an operation description
+* @param description = text between the parentheses in the meta-data file
+* @param length = length of the description, it isn't null terminated
+* @except Throws exception if the description is unknown or doesn't match the type
+*/
+void Operation::set_description( const char* description, const std::size_t length )
+{
+    auto is = [description, length]( const char* text ){
+        return std::strlen( text ) == length && std::memcmp( description, text, length ) == 0;
+    };
+
+    if( type != 'S' && type != 'A' && type != 'P' && type != 'I' && type != 'O' )
+    {
+        throw std::runtime_error( "Error: Unrecognized operation type, \
+        check meta-data file" );
+    }
+
+    device = NO_DEVICE;
+    if( type == 'P' && is("run") )
+    {
+        opcode = OP_RUN;
+    }
+    else if( ( type == 'A' || type == 'S' ) && is("start") )
+    {
+        opcode = OP_START;
+    }
+    else if( ( type == 'A' || type == 'S' ) && is("end") )
+    {
+        opcode = OP_END;
+    }
+    else if( ( type == 'I' || type == 'O' ) && device_from_name( description, length ) != NO_DEVICE )
+    {
+        opcode = OP_IO;
+        device = device_from_name( description, length );
+    }
+    else
+    {
+        throw std::runtime_error( "Error: Unrecognized operation " + std::string( 1, type ) + 
+            "(" + std::string( description, length ) + "), check meta-data file\n" );
+    }
+}
+
+/* Cycle time of an operation, devices are looked up by table
+* @param operation = operation with an interned description
+* @return usec per cycle
+*/
+int CycleTimes::cycle_time( const Operation& operation ) const
+{
+    if( operation.opcode == OP_RUN )
+    {
+        return processor;
+    }
+
+    else if( operation.opcode == OP_IO )
+    {
+        return device[operation.device];
+    }
+
+    return 0;
+}
+
+/* Duration of an operation from the cycles it has left
+* @param operation = operation with an interned description
+* @return usec, cycles * time per cycle
+*/
+long long CycleTimes::duration( const Operation& operation ) const
+{
+    return static_cast<long long>( cycle_time( operation ) ) * operation.cycles;
+}
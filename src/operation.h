@@ -6,27 +6,57 @@
 #ifndef OPERATION_H
 #define OPERATION_H
 
-#include <string>
+#include <cstddef>
+#include <type_traits>
 
+#include "device.h"
+
+/* What an operation does, interned from its meta-data description */
+enum Opcode : unsigned char
+{
+    OP_START, OP_END, OP_RUN, OP_IO
+};
 
 /* Model of a program operation, such as processing and I/O */
 class Operation
 {
 public:
-    // Run a single cycle
-    int run();
+    // Run count cycles of cycleTime usec each, returns the time they take. The cycle time
+    // isn't kept in the operation, it comes from CycleTimes
+    long long run( const int count, const int cycleTime );
 
     // Operation complete?
     bool done();
 
+    // Interns the meta-data description (end, hard drive, keyboard, monitor, run, printer,
+    // or start), throws if it doesn't fit the operation type
+    void set_description( const char* description, const std::size_t length );
+
     // status
     int cycles;
-    int duration = 0; // remaining cycles * time per cycle
+    int block = -1; // hard drive operations only: block address, -1 if the meta-data gives none
 
     // Operation information
     char type; // S (OS), A (Program), P (Processing), I (Input), or O (Output)
-    std::string description; // end, hard drive, keyboard, monitor, run, printer, or start
-    int cycleTime;
+    Opcode opcode;
+    Device device; // NO_DEVICE unless opcode is OP_IO
+};
+
+/* Time per cycle of every kind of operation in usec, converted from the units of the config */
+struct CycleTimes
+{
+    int processor = 0;
+    int device[DEVICE_COUNT] = {}; // indexed by Device, NO_DEVICE stays 0
+
+    // Time per cycle of an operation, 0 for program and OS flags
+    int cycle_time( const Operation& operation ) const;
+
+    // Time the cycles an operation has left take, usec
+    long long duration( const Operation& operation ) const;
 };
 
+// Operations are copied around on every context switch, keep them small and plain
+static_assert( sizeof(Operation) <= 16, "Operation should fit in 16 bytes" );
+static_assert( std::is_trivially_copyable<Operation>::value, "Operation should be trivially copyable" );
+
 #endif // OPERATION_H
@@ -5,18 +5,31 @@ Program::Program()
 {
 }
 
+/* Constructor for the Program class
+* @param operations = first operation of the program
+* @param count = number of operations
+* @param remainingTime = sum of the durations of all operations, usec
+* @param cycleTimes = time per cycle of the operations
+*/
+Program::Program( const Operation* operations, const std::size_t count, const long long remainingTime,
+    const CycleTimes* cycleTimes )
+    : nextOperation_( operations ), endOperation_( operations + count ), cycleTimes_( cycleTimes ),
+    firstOperation_( operations ), programTime_( remainingTime ), remainingProgramTime_( remainingTime )
+{
+}
+
 Program::~Program()
 {
 }
 
-/* Add an operation to queue, updating remaining time
-* @param operation to be added to queue
+/* Rewind to the first operation, as if the program was never run
 */
-void Program::add_operation( Operation newOperation )
+void Program::restart()
 {
-    newOperation.duration = newOperation.cycleTime * newOperation.cycles;
-    operations_.push_back(newOperation);    
-    remainingProgramTime_ += newOperation.duration;
+    nextOperation_ = firstOperation_;
+    hasReturned_ = false;
+    remainingProgramTime_ = programTime_;
+    state = START;
 }
 
 /* Add an earlier operation to the front of operation queue
@@ -25,15 +38,16 @@ void Program::add_operation( Operation newOperation )
 */
 void Program::return_operation( Operation operation )
 {
-    operations_.push_front(operation);
-    remainingProgramTime_ += operation.duration;
+    returned_ = operation;
+    hasReturned_ = true;
+    remainingProgramTime_ += cycleTimes_->duration( operation );
 }
 
 /* Returns true if all operations were completed
 */
 bool Program::done() const
 {
-    return operations_.empty();
+    return !hasReturned_ && nextOperation_ == endOperation_;
 }
 
 /* Returns next program operation
@@ -42,15 +56,23 @@ bool Program::done() const
 */
 Operation Program::next()
 {
-    Operation nextOperation = operations_.front();
-    operations_.pop_front();
-    remainingProgramTime_ -= nextOperation.duration;
+    Operation nextOperation;
+    if( hasReturned_ )
+    {
+        nextOperation = returned_;
+        hasReturned_ = false;
+    }
+    else
+    {
+        nextOperation = *nextOperation_++;
+    }
+    remainingProgramTime_ -= cycleTimes_->duration( nextOperation );
     return nextOperation;
 }
 
 /* remaining time getter
 */
-int Program::remaining_time() const
+long long Program::remaining_time() const
 {
     return remainingProgramTime_;
 }
@@ -59,5 +81,13 @@ int Program::remaining_time() const
 */
 int Program::remaining_operations() const
 {
-    return operations_.size();
+    return ( endOperation_ - nextOperation_ ) + ( hasReturned_ ? 1 : 0 );
+}
+
+/* Operations that weren't started yet, remaining_operations() of them unless an
+* interrupted operation was handed back
+*/
+const Operation* Program::upcoming_operations() const
+{
+    return nextOperation_;
 }
@@ -6,11 +6,12 @@
 #ifndef PROGRAM_H
 #define PROGRAM_H
 
+#include <chrono>
+#include <cstddef>
 #include <fstream>
 #include <iostream>
 #include <string>
 #include <stdexcept>
-#include <deque>
 
 #include "operation.h"
 
@@ -20,15 +21,55 @@ enum State
     START, BLOCKED, READY, RUNNING, EXIT
 };
     
+/* Optional program attributes, given in the meta-data as A(start name=value ...)0 */
+struct ProgramAttributes
+{
+    int arrival = 0; // msec after the simulation starts at which the program is admitted
+    int nice = 0; // -20 to 19, lower values get a larger share of the CPU under CFS
+    int period = 0; // msec between the releases of a periodic program, 0 if it isn't periodic
+    int deadline = 0; // msec after each release by which the program has to finish, 0 for the period
+    int jobs = 1; // times a periodic program is released
+
+    // msec after a release by which the program has to finish, 0 if it has no deadline
+    int relative_deadline() const { return deadline > 0 ? deadline : period; }
+};
+
+/* Bookkeeping of the scheduling policy, kept with the program so it can move between CPUs */
+struct SchedulingState
+{
+    int level = 0; // MLFQ: queue the program is in, 0 is the highest priority
+    long long levelTime = 0; // MLFQ: usec the program ran since it entered its level
+    long long boost = 0; // MLFQ: last priority boost the program took part in
+    long long vruntime = 0; // CFS: usec the program ran, weighted by its nice value
+};
+
+/* Time the current job spent in each state, kept for the metrics. Times are elapsed
+* simulation time, in nanoseconds */
+struct ProgramMetrics
+{
+    std::chrono::nanoseconds arrival{ 0 }; // admitted to the ready queue
+    std::chrono::nanoseconds firstRun{ -1 }; // -1 until the job first runs
+    std::chrono::nanoseconds lastTransition{ 0 }; // entered its current state
+    std::chrono::nanoseconds ready{ 0 }; // waiting in a ready queue
+    std::chrono::nanoseconds running{ 0 };
+    std::chrono::nanoseconds blocked{ 0 }; // waiting for I/O
+    int dispatches = 0;
+};
+
 /* Models a program which the OS can load and run */
 class Program
 {
 public:
     Program();
+
+    // Program made of count operations stored elsewhere, the storage must outlive it.
+    // The cycle times give the durations of the operations and have to outlive it too
+    Program( const Operation* operations, const std::size_t count, const long long remainingTime,
+        const CycleTimes* cycleTimes );
     ~Program();
 
-    /* Add a new operation to the back of the queue */
-    void add_operation( Operation operation );
+    /* Starts over at the first operation, for the next job of a periodic program */
+    void restart();
 
     /* Return operation to the front of the queue */
     void return_operation( Operation operation );
@@ -38,19 +79,34 @@ public:
 
     /* Information */
     bool done() const;
-    int remaining_time() const;
+    long long remaining_time() const; // usec
     int remaining_operations() const;
 
+    /* Operations that haven't been started yet, in order */
+    const Operation* upcoming_operations() const;
+
     /* Public members */        
     State state = START; // Current program state
     int id = 0; // ID of program, != 0 if program already started
+    ProgramAttributes attributes;
+    int job = 1; // number of the current job, counting the releases of a periodic program
+    SchedulingState scheduling;
+    ProgramMetrics metrics;
 
 private:
-    // Queue containing all program operations
-    std::deque<Operation> operations_; 
+    // Operations still to run, the program only walks over them and never copies the list
+    const Operation* nextOperation_ = nullptr;
+    const Operation* endOperation_ = nullptr;
+    const CycleTimes* cycleTimes_ = nullptr;
+    const Operation* firstOperation_ = nullptr;
+    long long programTime_ = 0;
+
+    // Operation that was interrupted and handed back, it runs before nextOperation_
+    Operation returned_;
+    bool hasReturned_ = false;
     
     // Remaining running time of program
-    int remainingProgramTime_ = 0; 
+    long long remainingProgramTime_ = 0; 
 };
 
-#endif // PROGRAM_H
\ No newline at end of file
+#endif // PROGRAM_H
@@ -17,7 +17,7 @@ using namespace std;
 
 // function prototypes
 
-void getNewOp( int percent, char opStr[] );
+void getNewOp( int percent, int numBlocks, char opStr[] );
 bool getOdds( int oddPercent );
 int getRandBetween( int low, int high );
 int checkLineLength( char str[], int startLen, ofstream &outF );
@@ -29,7 +29,7 @@ int main()
     // initialize program
 
        // initialize variables
-       int procPercentage, numOps, numPrograms;
+       int procPercentage, numOps, numPrograms, numBlocks;
        int progCtr, opCtr, lineLength = 0;
        char fileName[ STD_STR_LEN ];
        ofstream outFileObject;
@@ -59,6 +59,10 @@ int main()
     cout << "Enter number of programs: ";
     cin >> numPrograms;
 
+    // get size of hard drive, its operations get a random block on it
+    cout << "Enter number of hard drive blocks (0 for no block addresses): ";
+    cin >> numBlocks;
+
     // open file
     outFileObject.open( fileName );
 
@@ -90,7 +94,7 @@ int main()
         for( opCtr = 0; opCtr < numOps; opCtr++ )
            {
             // get new op
-            getNewOp( procPercentage, opString );
+            getNewOp( procPercentage, numBlocks, opString );
 
             // update length, output end of line as needed
             lineLength = checkLineLength( opString, lineLength, outFileObject );
@@ -156,9 +160,9 @@ bool getOdds( int oddPercent )
     return false;
    }
 
-void getNewOp( int percent, char opStr[] )
+void getNewOp( int percent, int numBlocks, char opStr[] )
    {
-    int cycleNum, recStartIndex = 0;
+    int cycleNum, blockNum, recStartIndex = 0;
     char numStr[ STD_STR_LEN ];
     static int ioOpVal = 0;
 
@@ -202,6 +206,29 @@ void getNewOp( int percent, char opStr[] )
            }
        }
 
+    // give hard drive operations a block address
+    if( numBlocks > 0 && strstr( opStr, "hard drive" ) != NULL )
+       {
+        blockNum = getRandBetween( 0, numBlocks - 1 );
+
+        opStr[ strlen( opStr ) - 1 ] = NULL_CHAR;
+
+        strcat( opStr, " block=" );
+
+        if( blockNum == 0 )
+           {
+            strcat( opStr, "0" );
+           }
+        else
+           {
+            intToString( blockNum, numStr, recStartIndex );
+
+            strcat( opStr, numStr );
+           }
+
+        strcat( opStr, ")" );
+       }
+
     cycleNum = getRandBetween( OPTIME_MIN, OPTIME_MAX );
 
     intToString( cycleNum, numStr, recStartIndex );
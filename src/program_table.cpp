@@ -0,0 +1,37 @@
+#include "program_table.h"
+
+#include <stdexcept>
+
+/* Constructor for the ProgramTable class, starts out empty
+*/
+ProgramTable::ProgramTable()
+    : chunks_( new std::unique_ptr<Program[]>[MAX_CHUNKS] ), size_( 0 )
+{
+}
+
+/* Slot count getter
+*/
+std::size_t ProgramTable::size() const
+{
+    return size_.load( std::memory_order_acquire );
+}
+
+/* Append a program, allocating a new chunk when the last one is full
+* @param program to store in the new slot
+* @except Throws exception if the table can't grow any further
+*/
+void ProgramTable::push_back( const Program& program )
+{
+    std::size_t index = size_.load( std::memory_order_relaxed );
+    std::size_t chunk = index >> CHUNK_BITS;
+    if( chunk == MAX_CHUNKS )
+    {
+        throw std::runtime_error( "Error: Too many programs in memory at once\n" );
+    }
+    if( !chunks_[chunk] )
+    {
+        chunks_[chunk].reset( new Program[CHUNK_SIZE] );
+    }
+    chunks_[chunk][ index & CHUNK_MASK ] = program;
+    size_.store( index + 1, std::memory_order_release );
+}
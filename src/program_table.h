@@ -0,0 +1,53 @@
+/*
+* Filename: program_table.h
+* Specifications for the ProgramTable object, the simulator's PCB table.
+*/
+
+#ifndef PROGRAM_TABLE_H
+#define PROGRAM_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "program.h"
+
+/* PCB table indexed by program slot. Programs are stored in fixed-size chunks that never
+* move, so a program stays where it is while the table grows and other threads may keep
+* using it. Only growing the table needs to be serialized by the caller. */
+class ProgramTable
+{
+public:
+    ProgramTable();
+
+    ProgramTable( const ProgramTable& ) = delete;
+    ProgramTable& operator=( const ProgramTable& ) = delete;
+
+    // Program in a slot, the slot has to exist
+    Program& operator[]( const std::size_t index )
+    {
+        return chunks_[ index >> CHUNK_BITS ][ index & CHUNK_MASK ];
+    }
+    const Program& operator[]( const std::size_t index ) const
+    {
+        return chunks_[ index >> CHUNK_BITS ][ index & CHUNK_MASK ];
+    }
+
+    // Number of slots
+    std::size_t size() const;
+
+    // Adds a slot at the end, throws once the table is full
+    void push_back( const Program& program );
+
+private:
+    static const int CHUNK_BITS = 12;
+    static const std::size_t CHUNK_SIZE = std::size_t(1) << CHUNK_BITS;
+    static const std::size_t CHUNK_MASK = CHUNK_SIZE - 1;
+    static const std::size_t MAX_CHUNKS = std::size_t(1) << 14;
+
+    // chunk directory, allocated once so it never moves either
+    std::unique_ptr<std::unique_ptr<Program[]>[]> chunks_;
+    std::atomic<std::size_t> size_;
+};
+
+#endif // PROGRAM_TABLE_H
@@ -0,0 +1,63 @@
+#include "realtime_schedulers.h"
+
+#include <functional>
+#include <limits>
+
+const long long PriorityScheduler::BACKGROUND = std::numeric_limits<long long>::max();
+
+/* Constructor for the PriorityScheduler class
+*/
+PriorityScheduler::PriorityScheduler( const SchedulerSettings& settings ) : Scheduler( settings )
+{
+}
+
+void PriorityScheduler::push( const int programIndex )
+{
+    Entry entry = { priority( programs_[programIndex] ), sequence_++, programIndex };
+    queue_.push( entry );
+}
+
+int PriorityScheduler::pop()
+{
+    int nextProgram = queue_.top().programIndex;
+    queue_.pop();
+    return nextProgram;
+}
+
+bool PriorityScheduler::empty() const
+{
+    return queue_.empty();
+}
+
+/* Constructor for the EDFScheduler class
+*/
+EDFScheduler::EDFScheduler( const SchedulerSettings& settings ) : PriorityScheduler( settings )
+{
+}
+
+/* Absolute deadline of the program's current job
+*/
+long long EDFScheduler::priority( const Program& program ) const
+{
+    const int deadline = program.attributes.relative_deadline();
+    if( deadline == 0 )
+    {
+        return BACKGROUND;
+    }
+    return static_cast<long long>( program.attributes.arrival ) + deadline;
+}
+
+/* Constructor for the RMScheduler class
+*/
+RMScheduler::RMScheduler( const SchedulerSettings& settings ) : PriorityScheduler( settings )
+{
+}
+
+/* Period of the program, a program with only a deadline ranks by its deadline
+*/
+long long RMScheduler::priority( const Program& program ) const
+{
+    const int period = program.attributes.period > 0 ? 
+        program.attributes.period : program.attributes.relative_deadline();
+    return period == 0 ? BACKGROUND : period;
+}
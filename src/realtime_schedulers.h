@@ -0,0 +1,72 @@
+/*
+* Filename: realtime_schedulers.h
+* Specifications for the real-time scheduling policies: EDF and RM.
+*/
+
+#ifndef REALTIME_SCHEDULERS_H
+#define REALTIME_SCHEDULERS_H
+
+#include <queue>
+#include <vector>
+
+#include "scheduler.h"
+
+/* Runs the ready program with the smallest priority value first, programs with equal
+* values run in the order they were queued. The priority of a program can't change
+* while it is queued */
+class PriorityScheduler : public Scheduler
+{
+public:
+    explicit PriorityScheduler( const SchedulerSettings& settings );
+
+    void push( const int programIndex ) override;
+    int pop() override;
+    bool empty() const override;
+
+protected:
+    // Lower values run first
+    virtual long long priority( const Program& program ) const = 0;
+
+    // Priority of programs that have no deadline, they run once no real-time program is ready
+    static const long long BACKGROUND;
+
+private:
+    struct Entry
+    {
+        long long priority;
+        unsigned long long sequence;
+        int programIndex;
+        bool operator>( const Entry& other ) const
+        {
+            if( priority != other.priority )
+            {
+                return priority > other.priority;
+            }
+            return sequence > other.sequence;
+        }
+    };
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue_;
+    unsigned long long sequence_ = 0;
+};
+
+/* Earliest Deadline First, the job whose deadline comes first runs first */
+class EDFScheduler final : public PriorityScheduler
+{
+public:
+    explicit EDFScheduler( const SchedulerSettings& settings );
+
+protected:
+    long long priority( const Program& program ) const override;
+};
+
+/* Rate Monotonic, the periodic program with the shortest period runs first */
+class RMScheduler final : public PriorityScheduler
+{
+public:
+    explicit RMScheduler( const SchedulerSettings& settings );
+
+protected:
+    long long priority( const Program& program ) const override;
+};
+
+#endif // REALTIME_SCHEDULERS_H
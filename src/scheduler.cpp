@@ -0,0 +1,173 @@
+#include "scheduler.h"
+
+#include <stdexcept>
+
+#include "basic_schedulers.h"
+#include "cfs_scheduler.h"
+#include "mlfq_scheduler.h"
+#include "realtime_schedulers.h"
+
+/* Constructor for the Scheduler class
+* @param settings = PCB table, config values and the policy's own settings
+*/
+Scheduler::Scheduler( const SchedulerSettings& settings )
+    : programs_( *settings.programs ), settings_( settings )
+{
+}
+
+Scheduler::~Scheduler()
+{
+}
+
+/* Quantum getter, every program gets the config's quantum unless the policy says otherwise
+* @param programIndex = program about to run
+*/
+int Scheduler::quantum( const int programIndex ) const
+{
+    return settings_.quantum;
+}
+
+/* Most policies don't care how long a program ran
+*/
+void Scheduler::ran( const int programIndex, const long long time )
+{
+}
+
+/* Most policies don't depend on the time
+*/
+void Scheduler::update( const std::chrono::nanoseconds now )
+{
+}
+
+/* Programs are numbered as they arrive unless the policy says otherwise
+*/
+bool Scheduler::numbers_on_first_run() const
+{
+    return false;
+}
+
+/* Parse a setting that has to be a positive number
+* @param value = text of the setting
+* @param error = message of the exception
+* @except Throws exception if value isn't a positive number
+*/
+int Scheduler::positive_setting( const std::string& value, const std::string& error )
+{
+    std::size_t end = 0;
+    int number = 0;
+    try
+    {
+        number = std::stoi( value, &end );
+    }
+    catch( const std::logic_error& )
+    {
+        throw std::runtime_error( error );
+    }
+    if( number <= 0 || end != value.size() )
+    {
+        throw std::runtime_error( error );
+    }
+    return number;
+}
+
+/* Policies aren't preemptive unless they say so
+*/
+bool Scheduler::preemptive() const
+{
+    return false;
+}
+
+/* Only asked of preemptive policies
+*/
+bool Scheduler::preempts( const int runningProgram, const long long runningTime ) const
+{
+    return false;
+}
+
+/* Registry, filled with the built-in policies on first use
+*/
+std::map<std::string, SchedulerRegistry::Entry>& SchedulerRegistry::entries()
+{
+    static std::map<std::string, Entry> registry = [](){
+        std::map<std::string, Entry> builtin;
+        builtin["FIFO-P"].factory = []( const SchedulerSettings& settings ){
+            return new FIFOScheduler( settings );
+        };
+        builtin["RR"].factory = []( const SchedulerSettings& settings ){
+            return new RRScheduler( settings );
+        };
+        builtin["SRTF-P"].factory = []( const SchedulerSettings& settings ){
+            return new SRTFScheduler( settings );
+        };
+        builtin["MLFQ"].factory = []( const SchedulerSettings& settings ){
+            return new MLFQScheduler( settings );
+        };
+        builtin["MLFQ"].settings = MLFQScheduler::setting_names();
+        builtin["CFS"].factory = []( const SchedulerSettings& settings ){
+            return new CFSScheduler( settings );
+        };
+        builtin["CFS"].settings = CFSScheduler::setting_names();
+        builtin["EDF"].factory = []( const SchedulerSettings& settings ){
+            return new EDFScheduler( settings );
+        };
+        builtin["RM"].factory = []( const SchedulerSettings& settings ){
+            return new RMScheduler( settings );
+        };
+        return builtin;
+    }();
+    return registry;
+}
+
+/* Add a policy, replacing any that had the same code
+* @param code = scheduling code that selects the policy in the config file
+* @param factory = creates the policy
+* @param settings = names of the optional config settings the policy reads
+*/
+void SchedulerRegistry::add( const std::string& code, Factory factory,
+    const std::vector<std::string>& settings )
+{
+    Entry &entry = entries()[code];
+    entry.factory = factory;
+    entry.settings = settings;
+}
+
+/* Check for a scheduling code
+*/
+bool SchedulerRegistry::contains( const std::string& code )
+{
+    return entries().count( code ) != 0;
+}
+
+/* Check whether a config setting belongs to any policy
+* @param name = setting name, as in the config file
+*/
+bool SchedulerRegistry::accepts_setting( const std::string& name )
+{
+    for( const auto &entry : entries() )
+    {
+        for( const std::string &setting : entry.second.settings )
+        {
+            if( setting == name )
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* Create a ready queue
+* @param code = scheduling code
+* @param settings = passed on to the policy
+* @except Throws exception if the code is unknown, or the policy rejects its settings
+*/
+std::unique_ptr<Scheduler> SchedulerRegistry::create( const std::string& code,
+    const SchedulerSettings& settings )
+{
+    auto entry = entries().find( code );
+    if( entry == entries().end() )
+    {
+        throw std::runtime_error( "Error: Unrecognized scheduling code\n" );
+    }
+    return std::unique_ptr<Scheduler>( entry->second.factory( settings ) );
+}
@@ -0,0 +1,113 @@
+/*
+* Filename: scheduler.h
+* Specifications for the Scheduler interface, and the registry that maps scheduling
+* codes to scheduling policies.
+*/
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "program_table.h"
+
+/* What a policy gets to work with when it is created */
+struct SchedulerSettings
+{
+    ProgramTable* programs = nullptr; // PCB table the queued indices refer to
+    int quantum = 0; // cycles, from the config file
+    int processorCycleTime = 0; // usec
+
+    // optional config settings the policy registered for, by name
+    std::map<std::string, std::string> options;
+};
+
+/* Ready queue of a single CPU. The policy decides which ready program runs next and
+* for how long. Programs are referred to by their index in the PCB table; per-program
+* state of a policy belongs in Program::scheduling, since programs may move between CPUs */
+class Scheduler
+{
+public:
+    explicit Scheduler( const SchedulerSettings& settings );
+    virtual ~Scheduler();
+
+    Scheduler( const Scheduler& ) = delete;
+    Scheduler& operator=( const Scheduler& ) = delete;
+
+    // Queues a program that became ready: it arrived, its I/O finished, or it was preempted
+    virtual void push( const int programIndex ) = 0;
+
+    // Removes the program that runs next, the queue can't be empty
+    virtual int pop() = 0;
+
+    virtual bool empty() const = 0;
+
+    // Cycles the program may run before its quantum expires, called right after pop()
+    virtual int quantum( const int programIndex ) const;
+
+    // How long the program that was popped last ran, in usec, before it was preempted,
+    // blocked or finished. Called before it is pushed again
+    virtual void ran( const int programIndex, const long long time );
+
+    // Current time of the CPU, given before every scheduling decision
+    virtual void update( const std::chrono::nanoseconds now );
+
+    // true if programs get their ID when they first run instead of when they arrive
+    virtual bool numbers_on_first_run() const;
+
+    // true if the policy decides with preempts() whether programs that become ready while
+    // another one runs take over the CPU. Otherwise any interrupt ends the running program's turn
+    virtual bool preemptive() const;
+
+    // Asked after programs became ready while another one runs, for preemptive policies.
+    // true if a queued program should run instead of the running one right away
+    // @param runningTime = usec the running program still needs to finish
+    virtual bool preempts( const int runningProgram, const long long runningTime ) const;
+
+protected:
+    // Positive whole number from one of the policy's settings, throws the error otherwise
+    static int positive_setting( const std::string& value, const std::string& error );
+
+    // policies may only change Program::scheduling of the programs
+    ProgramTable& programs_;
+    const SchedulerSettings settings_;
+};
+
+/* Scheduling policies by scheduling code. The built-in policies are always there,
+* more can be added before the first simulator is created */
+class SchedulerRegistry
+{
+public:
+    // Creates a policy instance, one is made for every simulated CPU
+    using Factory = std::function<Scheduler*( const SchedulerSettings& )>;
+
+    // Makes a policy available under a scheduling code, along with the names of the
+    // optional config settings it reads
+    static void add( const std::string& code, Factory factory,
+        const std::vector<std::string>& settings = std::vector<std::string>() );
+
+    static bool contains( const std::string& code );
+
+    // true if any policy reads a config setting of this name
+    static bool accepts_setting( const std::string& name );
+
+    // Creates a ready queue for the policy, throws if its settings are wrong
+    static std::unique_ptr<Scheduler> create( const std::string& code,
+        const SchedulerSettings& settings );
+
+private:
+    struct Entry
+    {
+        Factory factory;
+        std::vector<std::string> settings;
+    };
+    static std::map<std::string, Entry>& entries();
+};
+
+#endif // SCHEDULER_H
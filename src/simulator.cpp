@@ -1,16 +1,32 @@
 #include "simulator.h"
 
+#include <typeinfo>
+
+#include "basic_schedulers.h"
+#include "cfs_scheduler.h"
+#include "mlfq_scheduler.h"
+#include "realtime_schedulers.h"
+
+const long long Simulator::NO_ARRIVAL;
+
 /* Constructor for the Simulator class
 * Loads the config file for the simulator, if no problems occured then it
-* creates the program object (which reads the meta-data file). Also opens the
-* output file if needed, and sets precision of double/float outputs
+* creates the program object (which reads the meta-data file), and sets precision
+* of double/float outputs
 * @param file path for configuration file
 */
 Simulator::Simulator( const std::string filePath )
 {
     try
     {
-        load_config( filePath );
+        // attempt opening the file
+        std::ifstream fin( filePath, std::ifstream::in );
+        if(!fin)
+        {
+            std::string error = "Error: Unable to open file " + filePath + "\n";
+            throw std::runtime_error( error );
+        }
+        load_config( fin );
         load_meta_data( metaDataFilePath_ );
     }
     catch( const std::runtime_error& e )
@@ -21,10 +37,25 @@ Simulator::Simulator( const std::string filePath )
 
 
     std::cout.precision(6); // precision for printing doubles/floats
+}
 
-    if( logLocation_ == BOTH || logLocation_ == FILE )
+/* Constructor for a Simulator that shares its workload
+* Loads the config, then takes its programs from the workload instead of the meta-data file
+* @param config = contents of a configuration file
+* @param workload = programs to run, applying this config's cycle times
+*/
+Simulator::Simulator( std::istream& config, std::shared_ptr<const Workload> workload )
+    : workload_( workload )
+{
+    try
     {
-        fout_.open( logFilePath_ );
+        load_config( config );
+        load_meta_data( metaDataFilePath_ );
+    }
+    catch( const std::runtime_error& e )
+    {
+        std::cerr << e.what();
+        throw;
     }
 }
 
@@ -37,482 +68,2199 @@ Simulator::~Simulator()
 }
 
 /* Run the simulator on the loaded programs
+* Opens the log file if needed
 */
 void Simulator::run()
 {
-    // Announce beginning of sim and set starting time point
-    start_ = std::chrono::system_clock::now();
-    print("Simulator program starting");  
+    if( logLocation_ == BOTH || logLocation_ == FILE || logLocation_ == CHROME_TRACE )
+    {
+        fout_.open( logFilePath_ );
+    }
+    else if( logLocation_ == BINARY )
+    {
+        fout_.open( logFilePath_, std::ofstream::binary );
+    }
+
+    // Every simulated CPU starts out idle at time zero
+    cores_.clear();
+    for( int i = 0; i < cpuCount_; i++ )
+    {
+        cores_.emplace_back( new Core );
+        cores_.back()->id = i;
+    }
+    idleCores_ = 0;
+    windowEnd_ = std::chrono::nanoseconds( 0 );
+    metrics_.reset( metricsFilePath_.empty() ? nullptr : new MetricsCollector( cpuCount_ + 1 ) );
+    devices_.clear();
+    for( int device = 0; device < DEVICE_COUNT; device++ )
+    {
+        devices_.emplace_back( deviceChannels_[device], deviceQueues_[device],
+            device == HARD_DRIVE ? disk_ : DiskModel() );
+    }
+    deviceReleases_ = decltype( deviceReleases_ )();
+    finished_ = false;
+    error_ = nullptr;
 
-    // Run with the proper queue for the scheduling algorithm
-    if( schedulingCode_ == "FIFO-P" )
-    {   
-        run_helper<FIFO_Q>();
+    // Start the log writer
+    std::vector<std::ostream*> logOutputs;
+    if( logLocation_ == BOTH || logLocation_ == SCREEN )
+    {
+        logOutputs.push_back( &std::cout );
+    }
+    if( logLocation_ == BOTH || logLocation_ == FILE || logLocation_ == BINARY || logLocation_ == CHROME_TRACE )
+    {
+        logOutputs.push_back( &fout_ );
+    }
+    Logger::Format logFormat = Logger::TEXT;
+    if( logLocation_ == BINARY )
+    {
+        logFormat = Logger::BINARY;
+    }
+    else if( logLocation_ == CHROME_TRACE )
+    {
+        logFormat = Logger::CHROME;
     }
-    else if( schedulingCode_ == "RR" )
+    if( logLocation_ != NONE )
     {
-        run_helper<RR_Q>();
+        logger_.reset( new Logger( logOutputs, logFormat, cpuCount_ + 1, logBufferSize_, logOverflow_ ) );
     }
-    else // SRTF-P
+    if( logger_ && clockMode_ == VIRTUAL_TIME && cpuCount_ > 1 )
     {
-        run_helper<SRTF_Q>();
+        // cores run ahead of each other within a window, see synchronize()
+        logger_->set_watermark( 0 );
     }
 
-    print("Simulator program ending");
-}
+    // Announce beginning of sim and set starting time point
+    start_ = std::chrono::steady_clock::now();
+    if( clockMode_ == REAL_TIME )
+    {
+        // the wheel fires I/O completions at their deadlines, its tick only buckets them
+        ioTimers_.reset( new TimerWheel() );
+    }
+    print_system(SIMULATOR_START);
 
-/* Select next program from the ready queue - Priority Queues
-*/
-template<typename QueueType>
-Program Simulator::select_next_program( std::unique_ptr<QueueType> const &readyQueue )
-{
-    Program nextProgram = readyQueue->top();
-    readyQueue->pop();
-    return nextProgram;    
-}
+    // programs may still be read from here on, which can find errors in the meta-data file
+    try
+    {
+        run_helper();
+    }
+    catch( const std::runtime_error& e )
+    {
+        std::cerr << e.what();
+        throw;
+    }
 
-/* Select next program from the ready queue - Queues
-* This specification is needed because priority queue uses top() while queue uses front()
-*/
-template<>
-Program Simulator::select_next_program( std::unique_ptr<RR_Q> const &readyQueue )
-{
-    Program nextProgram = readyQueue->front();
-    readyQueue->pop();
-    return nextProgram;
-}
+    // every I/O has completed by now, so the wheel can be shut down
+    ioTimers_.reset();
 
-/* Run the simulator on the loaded programs
-* This helper was needed to used the same logic for different types of scheduling algorithms,
-* The only thing that has to be different the type of queue. Queue is for Round Robin while 
-* priority queues are used for FIFO-P and STRF-P.
-*/
-template<typename QueueType>
-void Simulator::run_helper()
-{
-    // Used to assign IDs to new programs
-    int programCounter = 0;
+    print_system(SIMULATOR_END);
 
-    // load programs into ready queue, setting them to ready
-    print("OS: preparing all processes");
-    std::unique_ptr<QueueType> readyQueue(new QueueType);    
-    for( Program program : programs_ )
+    // write out everything that is still queued
+    if( logger_ )
     {
-        program.state = READY;
-        if( schedulingCode_ != "SRTF-P")
+        logger_->stop();
+        if( logger_->dropped() > 0 )
         {
-            program.id = ++programCounter;
+            std::cerr << "Warning: " << logger_->dropped() 
+                << " log records were dropped because the log buffer was full" << std::endl;
         }
-        readyQueue->push(program);
+        logger_.reset();
     }
 
-    // Run the simulator until all the programs are finished
-    while( !readyQueue->empty() || !blockedPrograms_.empty() )
+    summary_ = Summary();
+    summary_.programs = programCounter_;
+    summary_.cpus = cpuCount_;
+    for( const std::unique_ptr<Core> &core : cores_ )
     {
-        // Process all interrupts that may have built up
-        while( !interrupts_.empty() )
-        {
-            Interrupt interrupt = interrupts_.front();
-            interrupts_.pop();
-
-            // processID is set to 0 if it's an OS interrupt (quantum timeout)
-            // otherwise, it is an I/O interrupt
-            if( interrupt.processID != 0 )
-            {
-                Program blockedProgram = blockedPrograms_.at( interrupt.processID );
-                blockedPrograms_.erase( interrupt.processID );  
-        
-                blockedProgram.state = READY;                              
-                readyQueue->push( blockedProgram );
-            }
-        }
-
-        // OS has programs that are ready for execution
-        if( !readyQueue->empty() )
-        {
-            print("OS: selecting next process");
-            Program program = select_next_program(readyQueue);
-
-            // SRTF needs to assign IDs dynamically to keep them relative to starting time
-            if( schedulingCode_ == "SRTF-P" && program.id == 0 )
-            {
-                program.id = ++programCounter;
-            }
-
-            // Run the program until interrupted
-            process_program( program );
-
-            // Return the program to the queue if it wasn't blocked or finished
-            if( program.state == RUNNING )
-            {
-                program.state = READY;
-                readyQueue->push( program );
-            }
-        }
+        summary_.elapsed = std::max( summary_.elapsed, elapsed( *core ) );
+        summary_.dispatches += core->dispatches;
+        summary_.busyTime += core->busyTime;
+        summary_.deadlineJobs += core->deadlineJobs;
+        summary_.deadlineMisses += core->deadlineMisses;
+        summary_.tardiness += core->tardiness;
+        summary_.maxTardiness = std::max( summary_.maxTardiness, core->maxTardiness );
+    }
 
-        // Could have used a flag to print this only once, but I like that the output is more visible
-        else
+    if( metrics_ )
+    {
+        std::ofstream metricsFile( metricsFilePath_ );
+        if( !metricsFile )
         {
-            print("OS Idle: Waiting for I/O to finish");
-            std::this_thread::sleep_for(
-                std::chrono::milliseconds( 20 )
-            ); 
+            throw std::runtime_error( "Error: Unable to open file " + metricsFilePath_ + "\n" );
         }
+        metrics_->write( metricsFile, metricsFormat_, summary_.elapsed, summary_.cpus, summary_.busyTime );
+        metrics_.reset();
     }
 }
 
-/* Process a program operation. Create a thread for each I/O operation.
-* @param program = current program that is being processed
+/* Summary getter, filled in by run()
 */
-void Simulator::process_program( Program &program )
+const Simulator::Summary& Simulator::summary() const
 {
-    //This will be state of the program exiting the function, nless the program ends or gets blocked
-    program.state = RUNNING;
-    const int programID = program.id;
-    Operation operation = program.next();
+    return summary_;
+}
 
-    // If the process is just starting, announce then go on to processing the next operation
-    if( operation.type == 'A' && operation.description == "start" )
+/* Move every program whose arrival time has come into the core's ready queue
+* Cores check the next arrival time without locking, so this is cheap while nothing arrives
+* @param core = core that handles the arrivals
+* @return number of programs admitted
+*/
+int Simulator::admit_programs( Core &core )
+{
+    const long long nextArrival = nextArrival_;
+    if( nextArrival == NO_ARRIVAL || std::chrono::milliseconds( nextArrival ) > elapsed( core ) )
     {
-        print("OS: starting process " + std::to_string(programID));
-        operation = program.next();
+        return 0;
     }
 
-    // Input/Output operation
-    if( operation.type == 'I' || operation.type == 'O' )
+    std::lock_guard<std::mutex> lock( workloadMutex_ );
+    const std::chrono::nanoseconds now = elapsed( core );
+    int programIndex;
+    int admitted = 0;
+    while( ( programIndex = next_arrival() ) >= 0 && 
+        std::chrono::milliseconds( programs_[programIndex].attributes.arrival ) <= now )
     {
-        print("Process " + std::to_string(programID) + ": starting I/O");
-        // create a thread for any I/O operation
-        std::thread IO_thread( [this, operation, programID](){
-            process_IO(operation, programID);
-        });
-        IO_thread.detach();
-
-        program.state = BLOCKED;
-        blockedPrograms_[program.id] = program;
+        push_ready( core, admit_next_program( core ) );
+        admitted++;
     }
+    return admitted;
+}
 
-    // Processing operation
-    else if( operation.type == 'P' )
+/* Take the program that arrives next, whose arrival time has to have come
+* Programs arriving at the very start are admitted silently, later arrivals are announced.
+* In streaming mode another program is read for every one that is admitted.
+* workloadMutex_ has to be held
+* @param core = core the arrival is announced on
+* @return index of the admitted program
+*/
+int Simulator::admit_next_program( Core &core )
+{
+    int programIndex = next_arrival();
+    if( !arrivals_.empty() && arrivals_.front() == programIndex )
     {
-        print("Process " + std::to_string(programID) + ": processing action");
-        int quantumCounter = 0;
-        while( !operation.done() && interrupts_.empty() )
-        {
-            quantumCounter++;
+        arrivals_.pop_front();
+    }
+    else
+    {
+        releases_.erase( releases_.begin() );
+    }
 
-            std::this_thread::sleep_for(
-                std::chrono::milliseconds( operation.run() )
-            );
-            
-            if(quantumCounter == quantum_)
-            {
-                interrupts_.push(Interrupt());
-                print("Interrupt: quantum expired");
-            }
-        }
+    Program &program = programs_[programIndex];
+    program.state = READY;
 
-        if( operation.done() )
-        {
-            print("Process " + std::to_string(programID) + ": end processing action");            
-        }
+    // it has been ready since its arrival time, whenever the core gets to admit it
+    program.metrics = ProgramMetrics();
+    program.metrics.arrival = std::chrono::milliseconds( program.attributes.arrival );
+    program.metrics.lastTransition = program.metrics.arrival;
 
-        else
-        {
-            program.return_operation(operation);
-        }
+    // some policies number programs when they first run, unless cores in parallel
+    // windows would race for the numbers
+    if( !idsOnFirstRun_ || ( clockMode_ == VIRTUAL_TIME && cores_.size() > 1 ) )
+    {
+        program.id = ++programCounter_;
+    }
+    activePrograms_++;
+    if( program.attributes.arrival > 0 )
+    {
+        print(core, PROCESS_ARRIVE, program.id);
     }
 
-    // Complete the program if the end operation is the current or the next one operation 
-    // (last operation in a program's queue is the program end flag),
-    if( program.remaining_operations() <= 1 && program.state != BLOCKED )
+    while( arrivals_.size() < admissionLookAhead_ && read_next_program() );
+    update_next_arrival();
+    return programIndex;
+}
+
+/* Publish the arrival time of the next program, workloadMutex_ has to be held
+*/
+void Simulator::update_next_arrival()
+{
+    const int programIndex = next_arrival();
+    nextArrival_ = programIndex < 0 ? NO_ARRIVAL : programs_[programIndex].attributes.arrival;
+}
+
+/* Find the next arrival, workloadMutex_ has to be held
+* Programs read from the workload go before jobs released at the same time
+* @return index of the program, -1 if nothing is left to arrive
+*/
+int Simulator::next_arrival() const
+{
+    if( releases_.empty() )
+    {
+        return arrivals_.empty() ? -1 : arrivals_.front();
+    }
+    if( arrivals_.empty() || programs_[arrivals_.front()].attributes.arrival > releases_.begin()->first )
     {
-        program.state = EXIT;
-        print("OS: removing process " + std::to_string(programID));
+        return releases_.begin()->second;
     }
+    return arrivals_.front();
 }
 
-/* Process I/O operation. This function is always called in a separate thread
-* @param operation = current operation that is being processed
-* @param programID = id of current program for printing
+/* Account for a job that finished. A job of a program with a deadline that finishes
+* after it is logged along with how late it was. A periodic program with jobs left is
+* released again one period after the job's release, or right away if it overran
+* @param core = core the job ran on
+* @param programIndex = index in programs_ of the program whose job finished
+* @return true if the program was released again
 */
-void Simulator::process_IO( const Operation& operation, const int programID )
+bool Simulator::finish_job( Core &core, const int programIndex )
 {
-    std::string startMessage = "I/O: process " + std::to_string(programID) + " starting ";
-    std::string endMessage = "Interrupt: process "+ std::to_string(programID) + " done with ";
-    if( operation.description == "hard drive" )
+    Program &program = programs_[programIndex];
+    if( metrics_ )
     {
-        std::string accessType = operation.type == 'I' ? "input" : "output";
-        print(startMessage + "hard drive " + accessType );
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds( operation.duration )
-        );
-        print(endMessage + "hard drive " + accessType );
+        metrics_->job_finished( core.id, program, program.metrics.lastTransition );
     }
-    else if( operation.description == "keyboard" )
+    const std::chrono::nanoseconds finishTime = elapsed( core );
+    const int finish = static_cast<int>( std::chrono::duration_cast<std::chrono::milliseconds>( finishTime ).count() );
+    const int deadline = program.attributes.relative_deadline();
+    if( deadline > 0 )
     {
-        print(startMessage + "keyboard input");
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds( operation.duration )
-        );
-        print(endMessage + "keyboard input");
+        // compared at full resolution, a job that is late by less than a msec still missed
+        core.deadlineJobs++;
+        const std::chrono::nanoseconds tardiness =
+            finishTime - std::chrono::milliseconds( program.attributes.arrival + deadline );
+        if( tardiness.count() > 0 )
+        {
+            core.deadlineMisses++;
+            core.tardiness += tardiness;
+            core.maxTardiness = std::max( core.maxTardiness, tardiness );
+
+            // logged in whole msec, rounded up so a miss never reads as 0
+            const long long lateness = ( tardiness.count() + 999999 ) / 1000000;
+            print(core, DEADLINE_MISSED, program.id, static_cast<int>( lateness ));
+        }
     }
-    else if( operation.description == "monitor" )
+
+    if( program.job >= program.attributes.jobs )
     {
-        print(startMessage + "monitor output");
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds( operation.duration )
-        ); 
-        print(endMessage + "monitor output");           
+        return false;
     }
-    else if( operation.description == "printer" )
+
+    // every job is a new process, numbered when it arrives
+    std::lock_guard<std::mutex> lock( workloadMutex_ );
+    program.restart();
+    program.job++;
+    program.id = 0;
+    program.attributes.arrival = std::max( program.attributes.arrival + program.attributes.period, finish );
+    releases_.insert( std::make_pair( program.attributes.arrival, programIndex ) );
+    update_next_arrival();
+    return true;
+}
+
+/* Put a program into a core's ready queue, and wake up an idle core that could steal it
+* @param core = core whose ready queue gets the program
+* @param programIndex = index in programs_ of the ready program
+*/
+void Simulator::push_ready( Core &core, const int programIndex )
+{
     {
-        print(startMessage + "printer output");
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds( operation.duration )
-        ); 
-        print(endMessage + "printer output");               
+        std::lock_guard<std::mutex> lock( core.queueMutex );
+        core.readyQueue->push( programIndex );
+        core.queued++;
     }
-    
-    interrupts_.push(Interrupt( programID ));
+    wake_idle_core();
 }
 
-/* Prints OS action to file, screen, or both, with elapsed time
-* @param Message to be printed
+/* Put a program into a core's ready queue from the core's own loop, without virtual calls
+* @param core = core whose ready queue gets the program
+* @param programIndex = index in programs_ of the ready program
 */
-void Simulator::print( const std::string message )
+template<class Policy>
+void Simulator::push_ready( Core &core, const int programIndex )
 {
-    std::chrono::duration<double> elapsedSeconds = std::chrono::system_clock::now()-start_;
-    auto time = elapsedSeconds.count();
-    if( logLocation_ == BOTH || logLocation_ == SCREEN )
     {
-        std::cout << std::fixed << time << " - " << message << std::endl;
+        std::lock_guard<std::mutex> lock( core.queueMutex );
+        ready_queue<Policy>( core ).push( programIndex );
+        core.queued++;
     }
-    if( logLocation_ == BOTH || logLocation_ == FILE )
+    if( !Policy::VIRTUAL )
     {
-        fout_ << std::fixed << time << " - " << message << std::endl;
-    }    
+        wake_idle_core();
+    }
 }
 
-/* Loads data from the config file
-* @param Path to config file
-* @except Throws exception if file wasn't found or file format isn't correct
+/* Take the next program for a core out of its own ready queue. In real-time mode a core
+* whose queue is empty steals from the core with the most ready programs instead, in
+* virtual-time mode programs only move between cores at the window barrier
+* @param core = core that is looking for work
+* @return index of the program in the PCB table, -1 if there was none
 */
-void Simulator::load_config( const std::string filePath )
+template<class Policy>
+int Simulator::take_program( Core &core )
 {
-    // attempt opening the file
-    std::ifstream fin( filePath, std::ifstream::in );
-    if(!fin)
     {
-        std::string error = "Error: Unable to open file " + filePath + "\n";
-        throw std::runtime_error( error );
+        std::lock_guard<std::mutex> lock( core.queueMutex );
+        typename Policy::Queue &queue = ready_queue<Policy>( core );
+        queue.update( elapsed<Policy>( core ) );
+        if( !queue.empty() )
+        {
+            core.queued--;
+            return queue.pop();
+        }
     }
-
-    // make sure the first line of the config file is correct
-    std::string configFormatLine;
-    std::getline(fin, configFormatLine, '\n');
-    if( configFormatLine != "Start Simulator Configuration File" )
+    if( cores_.size() == 1 || Policy::VIRTUAL )
     {
-        throw std::runtime_error( "Error: Incorrect config file format\n" );
+        return -1;
     }
 
-    // ignoring everything up to the ':' 
-    auto limit = std::numeric_limits<std::streamsize>::max();
-    fin.ignore( limit, ':' );
-
-    // make sure the configuration file is for the correct simulator version
-    float simVersion;
-    fin >> simVersion;
-    if( simVersion != simulatorVersion_ )
+    Core *victim = nullptr;
+    int mostQueued = 0;
+    for( std::unique_ptr<Core> &other : cores_ )
     {
-        std::cerr << std::endl 
-            << "Warning: Wrong simulator version." << std::endl            
-            << "Expected: " << simulatorVersion_ << std::endl
-            << "Given: " <<  simVersion << std::endl
-            << "The only reason this doesn't immediately end the program is because the provided \
-            test configuration file has its version set to 2.0 instead of 3.0." << std::endl 
-            << std::endl;
+        const int queued = other->queued;
+        if( queued > mostQueued )
+        {
+            mostQueued = queued;
+            victim = other.get();
+        }
     }
-    fin.ignore( limit, ':' );
-
-    // get the rest of the data from the config file
-    fin >> metaDataFilePath_;
-    fin.ignore( limit, ':' );
-
-    fin >> schedulingCode_;
-    fin.ignore( limit, ':' );
-    if( schedulingCode_ != "RR" &&
-        schedulingCode_ != "FIFO-P" &&
-        schedulingCode_ != "SRTF-P" )
+    if( victim == nullptr )
     {
-        throw std::runtime_error( "Error: Unrecognized scheduling code\n" );
+        return -1;
     }
 
-    fin >> quantum_;
-    fin.ignore( limit, ':' );
-
-    fin >> processorCycleTime_;
-    fin.ignore( limit, ':' );
-
-    fin >> monitorDisplayTime_;
-    fin.ignore( limit, ':' );
-
-    fin >> hardDriveCycleTime_;
-    fin.ignore( limit, ':' );
-
-    fin >> printerCycleTime_;
-    fin.ignore( limit, ':' );
-
-    fin >> keyboardCycleTime_;
-    fin.ignore( limit, ':' );
+    // every core's queue was made by the same policy
+    std::lock_guard<std::mutex> lock( victim->queueMutex );
+    typename Policy::Queue &queue = ready_queue<Policy>( *victim );
+    if( queue.empty() )
+    {
+        return -1;
+    }
+    victim->queued--;
+    core.steals++;
+    return queue.pop();
+}
 
-    std::string logString;
-    fin >> std::ws; // ignore the space after :
-    std::getline(fin, logString, '\n');
+/* Run the simulator on the loaded programs
+* Every core gets its own ready queue, made by the scheduling policy that the scheduling
+* code selects. Queues only hold indices into programs_, the programs themselves never move.
+* A single core runs on the calling thread, with more than one every core runs on a host
+* thread of its own
+*/
+void Simulator::run_helper()
+{
+    // load programs into ready queue, setting them to ready
+    print_system(OS_PREPARING);
+    for( std::unique_ptr<Core> &core : cores_ )
+    {
+        core->readyQueue = SchedulerRegistry::create( schedulingCode_, schedulerSettings_ );
+    }
+    idsOnFirstRun_ = cores_[0]->readyQueue->numbers_on_first_run();
+    const CoreLoop loop = select_core_loop( *cores_[0]->readyQueue );
 
-    // transform the log location to enum for easier processing later
-    if( logString == "Log to Both")
+    if( cores_.size() == 1 )
     {
-        logLocation_ = BOTH;
+        (this->*loop)( *cores_[0] );
+        return;
     }
-    else if( logString == "Log to File" )
+
+    std::vector<std::thread> threads;
+    for( std::unique_ptr<Core> &core : cores_ )
     {
-        logLocation_ = FILE;
+        Core *corePointer = core.get();
+        threads.emplace_back( [this, loop, corePointer](){
+            try
+            {
+                (this->*loop)( *corePointer );
+            }
+            catch( ... )
+            {
+                abort( std::current_exception() );
+            }
+        });
     }
-    else
+    for( std::thread &thread : threads )
     {
-        logLocation_ = SCREEN;
+        thread.join();
     }
-    fin.ignore( limit, ':' );
-
-    fin >> logFilePath_;
-
-    // make sure the config file ends here
-    fin >> configFormatLine;
-    if( configFormatLine != "End" )
+    if( error_ )
     {
-        throw std::runtime_error( "Error: Incorrect config file format\n" );
+        std::rethrow_exception( error_ );
     }
-
-    fin.close();
 }
 
-/* Loads each operation specified in the meta-data file into queue 
-* @param file path for the meta data file
+/* Pick the version of the core loop that was compiled for this run's ready queue, clock
+* mode and log. The ready queue is told apart by its class rather than by the scheduling
+* code, so a built-in code that was replaced in the registry gets the generic loop
+* @param queue = ready queue of the first core, every core has one of the same class
+* @return core loop to run every core with
 */
-void Simulator::load_meta_data( const std::string filePath )
+Simulator::CoreLoop Simulator::select_core_loop( const Scheduler& queue ) const
 {
-
-    // string object that's used throughout this function
-    std::string input;
-
-    // attempt opening the file
-    std::ifstream fin( filePath, std::ifstream::in );
-    if(!fin)
+    const std::type_info &type = typeid( queue );
+    if( type == typeid( RRScheduler ) )
     {
-        std::string error = "Error: Unable to open file " + filePath + "\n";
-        throw std::runtime_error( error );
+        return core_loop_for<RRScheduler>();
     }
-
-    // make sure the beginning of the file is correct
-    std::getline(fin, input, ';');
-    fin >> std::ws;
-    if( input != "Start Program Meta-Data Code:\nS(start)0" )
+    if( type == typeid( FIFOScheduler ) )
     {
-        throw std::runtime_error( "Error: Incorrect meta-data file format: \
-            Simulator start flag is missing\n" );
+        return core_loop_for<FIFOScheduler>();
     }
-
-    Operation operation;
-    int paranthesisLocation;
-
-
-    while( fin.peek() != 'S' )
+    if( type == typeid( SRTFScheduler ) )
     {
-        Program newProgram;
-
-        // Get all program data
-        do
-        {
-            // after getline, string looks like this: "A(start)0"   
-            std::getline(fin, input, ';');
-            paranthesisLocation = input.find(')');
-
-            // parsing Operation object
-            operation.type = input.front();        
-            operation.description = input.substr(2, paranthesisLocation-2);
-            operation.cycles = std::stoi(
-                std::string( input.begin()+paranthesisLocation+1, input.end()) 
-            );
-
-            // find and set cycle time of the operation
-            set_operation_cycle_time(operation);
-
-            // insert operation into queue
-            newProgram.add_operation(operation);
-
-            // eat whitespace
-            fin >> std::ws;
-        } while( input != "A(end)0" );
-
-        // insert the complete program into list of programs
-        programs_.push_back(newProgram);
+        return core_loop_for<SRTFScheduler>();
     }
-
-    // Make sure the simulator end flag is there
-    std::getline(fin, input, '.');
-    fin >> std::ws;
-    if( input != "S(end)0" )
+    if( type == typeid( MLFQScheduler ) )
     {
-        throw std::runtime_error( "Error: Incorrect meta-data file format: \
-            Simulator end flag is missing\n" );
+        return core_loop_for<MLFQScheduler>();
     }
-
-    // make sure the last line of the file is correct
-    std::getline(fin, input, '.');
-    if( input != "End Program Meta-Data Code" )
+    if( type == typeid( CFSScheduler ) )
     {
-        throw std::runtime_error( "Error: Incorrect meta-data file format: \
-            Meta-Data file does not end after simulator operations end\n" );
+        return core_loop_for<CFSScheduler>();
     }
-
-    fin.close();
+    if( type == typeid( EDFScheduler ) )
+    {
+        return core_loop_for<EDFScheduler>();
+    }
+    if( type == typeid( RMScheduler ) )
+    {
+        return core_loop_for<RMScheduler>();
+    }
+    return core_loop_for<Scheduler>();
 }
 
-void Simulator::set_operation_cycle_time( Operation &operation )
+/* Core loop for a ready queue class, in the clock mode and with the log of this run
+*/
+template<class Queue>
+Simulator::CoreLoop Simulator::core_loop_for() const
 {
-    if( operation.type == 'P' )
+    if( clockMode_ == VIRTUAL_TIME )
     {
-        operation.cycleTime = processorCycleTime_;
+        return logger_ ? &Simulator::core_loop<LoopPolicy<Queue, true, true>>
+            : &Simulator::core_loop<LoopPolicy<Queue, true, false>>;
     }
+    return logger_ ? &Simulator::core_loop<LoopPolicy<Queue, false, true>>
+        : &Simulator::core_loop<LoopPolicy<Queue, false, false>>;
+}
+
+/* Ready queue of a core, as the class the core loop was compiled for
+* @param core = core whose queue it is
+*/
+template<class Policy>
+typename Policy::Queue& Simulator::ready_queue( Core &core )
+{
+    return static_cast<typename Policy::Queue&>( *core.readyQueue );
+}
+
+/* Run one core until all the programs are finished
+* @param core = simulated CPU to run
+*/
+template<class Policy>
+void Simulator::core_loop( Core &core )
+{
+    // virtual time with several cores is simulated in windows, see synchronize()
+    const bool windowed = Policy::VIRTUAL && cores_.size() > 1;
 
-    else if( operation.type == 'I' || operation.type == 'O' )
+    while( !finished_ )
     {
-        if( operation.description == "hard drive" )
+        if( windowed )
         {
-            operation.cycleTime = hardDriveCycleTime_;
+            while( core.time >= windowEnd_ && !finished_ )
+            {
+                synchronize( core );
+            }
+            if( finished_ )
+            {
+                break;
+            }
+        }
+        else
+        {
+            // Admit programs that arrived in the meantime
+            admit_programs( core );
+        }
+
+        // Process all interrupts that may have built up
+        Interrupt interrupt;
+        while( core.interrupts.try_pop( interrupt ) )
+        {
+            // programIndex is set to QUANTUM if it's an OS interrupt (quantum timeout),
+            // WAKEUP only gets an idle core going again, otherwise it is an I/O interrupt
+            if( interrupt.programIndex >= 0 )
+            {
+                io_interrupt( core, interrupt.programIndex, interrupt.sent );
+            }
+        }
+
+        const HostStats::Clock::time_point selectStart = 
+            hostStatistics_ ? HostStats::Clock::now() : HostStats::Clock::time_point();
+        int programIndex = take_program<Policy>( core );
+
+        // OS has programs that are ready for execution
+        if( programIndex >= 0 )
+        {
+            if( hostStatistics_ )
+            {
+                core.hostStats.selection.record( HostStats::Clock::now() - selectStart );
+            }
+            print<Policy>( core, OS_SELECTING );
+            core.announcedIdle = false;
+            core.dispatches++;
+            core.hostStats.dispatches++;
+            if( programIndex != core.lastProgram )
+            {
+                core.hostStats.contextSwitches++;
+                core.lastProgram = programIndex;
+            }
+            Program &program = programs_[programIndex];
+
+            // SRTF needs to assign IDs dynamically to keep them relative to starting time
+            if( idsOnFirstRun_ && program.id == 0 )
+            {
+                program.id = ++programCounter_;
+            }
+
+            // Run the program until interrupted, then tell the policy how long it ran.
+            // Only this core touches the program until it is queued again
+            typename Policy::Queue &queue = ready_queue<Policy>( core );
+            const int quantum = queue.quantum( programIndex );
+            const std::chrono::nanoseconds busyBefore = core.busyTime;
+            process_program<Policy>( core, programIndex, quantum );
+            queue.ran( programIndex,
+                std::chrono::duration_cast<std::chrono::microseconds>( core.busyTime - busyBefore ).count() );
+
+            // Return the program to the queue if it wasn't blocked or finished
+            if( program.state == RUNNING )
+            {
+                set_state( core, program, READY );
+                push_ready<Policy>( core, programIndex );
+            }
+
+            else if( program.state == EXIT )
+            {
+                // A periodic program with jobs left is released again and arrives once more.
+                // When streaming, finished programs make room for the ones read later
+                if( !finish_job( core, programIndex ) && admissionLookAhead_ > 0 )
+                {
+                    std::lock_guard<std::mutex> lock( workloadMutex_ );
+                    freePrograms_.push_back( programIndex );
+                }
+
+                // idle cores have to notice that the last program is done
+                if( --activePrograms_ == 0 )
+                {
+                    wake_all_cores();
+                }
+            }
+        }
+
+        else if( !windowed && finished() )
+        {
+            break;
+        }
+
+        // Could have used a flag to print this only once, but I like that the output is more
+        // visible. With several cores the flag is needed though, idle cores wake up a lot
+        else
+        {
+            if( !core.announcedIdle || cores_.size() == 1 )
+            {
+                print<Policy>( core, OS_IDLE );
+                core.announcedIdle = true;
+            }
+
+            if( windowed )
+            {
+                // nothing happens on this core before its next I/O completes, and it
+                // has to wait for the others at the end of the window anyway
+                std::chrono::nanoseconds next = windowEnd_;
+                if( !core.events.empty() )
+                {
+                    next = std::min( next, core.events.top().time );
+                }
+                advance_clock( core, next );
+            }
+            else if( Policy::VIRTUAL )
+            {
+                // nothing can happen before the next I/O completes or the next program
+                // arrives, so skip straight to it
+                std::chrono::nanoseconds next = std::chrono::nanoseconds::max();
+                if( !core.events.empty() )
+                {
+                    next = core.events.top().time;
+                }
+                const long long nextArrival = nextArrival_;
+                if( nextArrival != NO_ARRIVAL )
+                {
+                    next = std::min<std::chrono::nanoseconds>( next,
+                        std::chrono::milliseconds( nextArrival ) );
+                }
+                assert( next != std::chrono::nanoseconds::max() );
+                advance_clock( core, next );
+            }
+            else
+            {
+                idle( core );
+            }
+        }
+    }
+}
+
+/* Barrier at the end of a window of simulated time, for virtual-time mode with several
+* cores. Within a window every core only touches its own queue, interrupts and clock, so
+* the cores run in parallel and still give the same result every time. The last core to
+* arrive prepares the next window while the others wait: it admits the programs that
+* arrived to the least loaded cores and hands idle cores a program of the busiest one
+* @param core = core that reached the end of the window
+*/
+void Simulator::synchronize( Core &core )
+{
+    std::unique_lock<std::mutex> lock( barrierMutex_ );
+    if( ++barrierWaiting_ < static_cast<int>( cores_.size() ) )
+    {
+        const unsigned long long generation = barrierGeneration_;
+        barrierWakeup_.wait( lock, [this, generation](){
+            return barrierGeneration_ != generation || finished_;
+        });
+        return;
+    }
+    barrierWaiting_ = 0;
+    barrierGeneration_++;
+
+    // operations that waited for a device, or ask for one, start on its free channels
+    schedule_devices( windowEnd_ );
+
+    // when every core is idle, skip straight to the next I/O completion or arrival
+    std::chrono::nanoseconds windowStart = windowEnd_;
+    std::chrono::nanoseconds next = std::chrono::nanoseconds::max();
+    bool allIdle = true;
+    for( std::unique_ptr<Core> &other : cores_ )
+    {
+        allIdle = allIdle && other->queued == 0 && other->interrupts.empty();
+        if( !other->events.empty() )
+        {
+            next = std::min( next, other->events.top().time );
+        }
+    }
+    if( !deviceReleases_.empty() )
+    {
+        next = std::min( next, deviceReleases_.top().first );
+    }
+    const long long nextArrival = nextArrival_;
+    if( nextArrival != NO_ARRIVAL )
+    {
+        next = std::min<std::chrono::nanoseconds>( next, std::chrono::milliseconds( nextArrival ) );
+    }
+    if( allIdle && next != std::chrono::nanoseconds::max() && next > windowStart )
+    {
+        windowStart = next;
+        for( std::unique_ptr<Core> &other : cores_ )
+        {
+            if( other->time < windowStart )
+            {
+                advance_clock( *other, windowStart );
+            }
+        }
+    }
+
+    // admit arrivals, the other cores are waiting so their queues and log rings are free to use
+    {
+        std::lock_guard<std::mutex> workloadLock( workloadMutex_ );
+        int programIndex;
+        while( ( programIndex = next_arrival() ) >= 0 && 
+            std::chrono::milliseconds( programs_[programIndex].attributes.arrival ) <= windowStart )
+        {
+            Core *target = cores_[0].get();
+            for( std::unique_ptr<Core> &other : cores_ )
+            {
+                if( other->queued < target->queued )
+                {
+                    target = other.get();
+                }
+            }
+            target->readyQueue->push( admit_next_program( *target ) );
+            target->queued++;
+        }
+    }
+
+    // a core with nothing to do takes a program that would otherwise wait behind another one
+    for( std::unique_ptr<Core> &thief : cores_ )
+    {
+        if( thief->queued > 0 )
+        {
+            continue;
+        }
+        Core *victim = nullptr;
+        int mostQueued = 1;
+        for( std::unique_ptr<Core> &other : cores_ )
+        {
+            if( other->queued > mostQueued )
+            {
+                mostQueued = other->queued;
+                victim = other.get();
+            }
+        }
+        if( victim == nullptr )
+        {
+            break;
+        }
+        thief->readyQueue->push( victim->readyQueue->pop() );
+        victim->queued--;
+        thief->queued++;
+        thief->steals++;
+    }
+
+    // every core is past the window start, so anything logged before it can be written
+    if( logger_ )
+    {
+        logger_->set_watermark( std::chrono::duration_cast<std::chrono::microseconds>( windowStart ).count() );
+    }
+    windowEnd_ = windowStart + std::chrono::microseconds( syncWindow_ );
+    if( activePrograms_ == 0 && nextArrival_ == NO_ARRIVAL )
+    {
+        finished_ = true;
+    }
+    barrierWakeup_.notify_all();
+}
+
+/* Sleep until a real-time core may have something to do: an interrupt, the next arrival,
+* or, with several cores, a program that was queued on another core and can be stolen
+* @param core = core that has nothing to run
+*/
+void Simulator::idle( Core &core )
+{
+    if( cores_.size() > 1 )
+    {
+        // look for work once more after going idle, a core that queues a program
+        // from here on sees the flag and wakes this one up
+        core.idle = true;
+        idleCores_++;
+        bool work = !core.interrupts.empty() || finished();
+        for( std::unique_ptr<Core> &other : cores_ )
+        {
+            work = work || other->queued > 0;
+        }
+        if( work )
+        {
+            if( core.idle.exchange( false ) )
+            {
+                idleCores_--;
+            }
+            return;
+        }
+    }
+
+    const long long nextArrival = nextArrival_;
+    if( nextArrival != NO_ARRIVAL )
+    {
+        // sleep until an interrupt or the next program arrives
+        core.interrupts.wait_until( host_time( std::chrono::milliseconds( nextArrival ) ) );
+    }
+    else
+    {
+        // sleep until the I/O wheel or another core delivers the next interrupt
+        core.interrupts.wait();
+    }
+
+    if( core.idle.exchange( false ) )
+    {
+        idleCores_--;
+    }
+}
+
+/* Check whether the run is over
+* @return true once every program arrived and exited, or the run was aborted
+*/
+bool Simulator::finished() const
+{
+    return finished_ || ( activePrograms_ == 0 && nextArrival_ == NO_ARRIVAL );
+}
+
+/* Stop every core after one of them failed, the first error is rethrown by run()
+* @param error = what the failing core threw
+*/
+void Simulator::abort( std::exception_ptr error )
+{
+    {
+        std::lock_guard<std::mutex> lock( barrierMutex_ );
+        if( !error_ )
+        {
+            error_ = error;
+        }
+        finished_ = true;
+    }
+    barrierWakeup_.notify_all();
+    wake_all_cores();
+}
+
+/* Wake up one idle core, if there is any, so it can steal work
+* Only real-time cores sleep, in virtual-time mode nothing needs to be woken up
+*/
+void Simulator::wake_idle_core()
+{
+    if( idleCores_ == 0 || clockMode_ == VIRTUAL_TIME )
+    {
+        return;
+    }
+    for( std::unique_ptr<Core> &other : cores_ )
+    {
+        if( other->idle && other->idle.exchange( false ) )
+        {
+            idleCores_--;
+            other->interrupts.push(Interrupt( Interrupt::WAKEUP ));
+            return;
+        }
+    }
+}
+
+/* Wake up every real-time core, whether it is idle or not
+*/
+void Simulator::wake_all_cores()
+{
+    if( cores_.size() == 1 || clockMode_ == VIRTUAL_TIME )
+    {
+        return;
+    }
+    for( std::unique_ptr<Core> &other : cores_ )
+    {
+        other->interrupts.push(Interrupt( Interrupt::WAKEUP ));
+    }
+}
+
+/* Process a program operation. I/O operations are handed off to start_IO.
+* @param core = core the program runs on
+* @param programIndex = index in programs_ of the program that is being processed
+* @param quantum = cycles the program may run before it is interrupted
+*/
+template<class Policy>
+void Simulator::process_program( Core &core, const int programIndex, const int quantum )
+{
+    //This will be state of the program exiting the function, nless the program ends or gets blocked
+    Program &program = programs_[programIndex];
+    set_state( core, program, RUNNING );
+    const int programID = program.id;
+    Operation operation = program.next();
+
+    // If the process is just starting, announce then go on to processing the next operation
+    if( operation.opcode == OP_START )
+    {
+        print<Policy>( core, PROCESS_START, programID );
+        operation = program.next();
+    }
+
+    // Input/Output operation
+    if( operation.opcode == OP_IO )
+    {
+        print<Policy>( core, PROCESS_IO, programID );
+        set_state( core, program, BLOCKED );
+        start_IO( core, operation, programIndex );
+    }
+
+    // Processing operation
+    else if( operation.opcode == OP_RUN )
+    {
+        print<Policy>( core, PROCESS_RUN, programID );
+        int quantumCounter = 0;
+
+        // real-time cycles end on deadlines counted from here, so a cycle that
+        // oversleeps doesn't push back the ones after it
+        if( !Policy::VIRTUAL )
+        {
+            core.time = elapsed<Policy>( core );
+        }
+        while( !operation.done() && !preempted<Policy>( core, programIndex, operation ) )
+        {
+            const int cycles = run_cycles<Policy>( core, operation, 
+                std::max( 1, std::min( operation.cycles, quantum - quantumCounter ) ) );
+            quantumCounter += cycles;
+            core.busyTime += std::chrono::microseconds(
+                static_cast<long long>( cycles ) * cycleTimes_.cycle_time( operation ) );
+            
+            if(quantumCounter == quantum)
+            {
+                core.interrupts.push(Interrupt());
+                print<Policy>( core, QUANTUM_EXPIRED );
+            }
+        }
+
+        if( operation.done() )
+        {
+            print<Policy>( core, PROCESS_RUN_END, programID );            
+        }
+
+        else
+        {
+            program.return_operation(operation);
+        }
+    }
+
+    // Complete the program if the end operation is the current or the next one operation 
+    // (last operation in a program's queue is the program end flag),
+    if( program.remaining_operations() <= 1 && program.state != BLOCKED )
+    {
+        set_state( core, program, EXIT );
+        print<Policy>( core, PROCESS_REMOVE, programID );
+    }
+}
+
+/* Check whether a running program has to stop. Usually any pending interrupt stops it,
+* and core_loop() handles the interrupt. A preemptive policy is asked instead: programs
+* that became ready are queued right away, arrivals included, and the running program
+* only stops if the policy prefers one of them or its quantum expired
+* @param core = core the program runs on
+* @param programIndex = index in programs_ of the running program
+* @param operation = operation the program is running
+*/
+template<class Policy>
+bool Simulator::preempted( Core &core, const int programIndex, const Operation& operation )
+{
+    typename Policy::Queue &queue = ready_queue<Policy>( core );
+    if( !queue.preemptive() )
+    {
+        return !core.interrupts.empty();
+    }
+
+    bool expired = false;
+    bool ready = false;
+    Interrupt interrupt;
+    while( core.interrupts.try_pop( interrupt ) )
+    {
+        if( interrupt.programIndex >= 0 )
+        {
+            io_interrupt( core, interrupt.programIndex, interrupt.sent );
+            ready = true;
+        }
+        expired = expired || interrupt.programIndex == Interrupt::QUANTUM;
+    }
+
+    // with several virtual-time cores programs only arrive at the window barrier
+    if( !Policy::VIRTUAL || cores_.size() == 1 )
+    {
+        ready = admit_programs( core ) > 0 || ready;
+    }
+    if( expired || !ready )
+    {
+        return expired;
+    }
+
+    const Program &program = programs_[programIndex];
+    bool preempt;
+    {
+        std::lock_guard<std::mutex> lock( core.queueMutex );
+        preempt = queue.preempts( programIndex, program.remaining_time() + cycleTimes_.duration( operation ) );
+    }
+    if( preempt )
+    {
+        print<Policy>( core, PROCESS_PREEMPTED, program.id );
+    }
+    return preempt;
+}
+
+/* Make the program whose I/O completed ready again
+* @param core = core that took the interrupt
+* @param programIndex = index in programs_ of the program
+* @param sent = host time the interrupt was posted, only set with host statistics on
+*/
+void Simulator::io_interrupt( Core &core, const int programIndex, const HostStats::Clock::time_point sent )
+{
+    if( hostStatistics_ )
+    {
+        core.hostStats.interruptDelivery.record( HostStats::Clock::now() - sent );
+    }
+    set_state( core, programs_[programIndex], READY );
+    push_ready( core, programIndex );
+}
+
+/* Ask the operation's device for an I/O operation. A device with a limited number of
+* channels may have to queue it, with several virtual-time cores that is only decided
+* at the end of the window, when the requests of every core are known
+* @param core = core the program was running on, it gets the completion interrupt
+* @param operation = I/O operation that is starting
+* @param programIndex = index in programs_ of the program which requested the I/O
+*/
+void Simulator::start_IO( Core &core, const Operation& operation, const int programIndex )
+{
+    IORequest request;
+    request.operation = operation;
+    request.duration = cycleTimes_.duration( operation );
+    request.programIndex = programIndex;
+    request.core = core.id;
+    request.time = elapsed( core );
+
+    DeviceChannels &device = devices_[operation.device];
+    if( device.limited() )
+    {
+        if( clockMode_ == VIRTUAL_TIME && cores_.size() > 1 )
+        {
+            core.ioRequests.push_back( request );
+            return;
+        }
+        std::lock_guard<std::mutex> lock( devicesMutex_ );
+        if( !device.request( request ) )
+        {
+            return;
+        }
+    }
+    dispatch_IO( request, request.time, core.id );
+}
+
+/* Start an I/O operation on a device channel. In real-time mode its completion is a timer
+* on the I/O wheel, in virtual-time mode it is scheduled on the core's simulated clock instead
+* @param request = I/O operation and the core that gets the completion interrupt
+* @param start = simulated time the operation starts at
+* @param producer = log ring and metrics shard of the calling thread
+*/
+void Simulator::dispatch_IO( const IORequest& request, const std::chrono::nanoseconds start, const int producer )
+{
+    Core &core = *cores_[request.core];
+    const Operation &operation = request.operation;
+    const int programIndex = request.programIndex;
+    const std::chrono::nanoseconds end = start + std::chrono::microseconds( request.duration );
+    begin_IO( core, request, start, producer );
+    if( clockMode_ == VIRTUAL_TIME )
+    {
+        IOEvent event;
+        event.time = end;
+        if( cores_.size() > 1 && devices_[operation.device].limited() )
+        {
+            // started at the barrier: the channel frees up at the end of the operation,
+            // but the core can't take the interrupt before the window it is in
+            deviceReleases_.push( std::make_pair( end, static_cast<int>( operation.device ) ) );
+            event.time = std::max( end, std::max( windowEnd_, core.time ) );
+        }
+        event.sequence = core.eventCounter++;
+        event.operation = operation;
+        event.programIndex = programIndex;
+        core.events.push( event );
+    }
+    else
+    {
+        Core *corePointer = &core;
+        ioTimers_->schedule( host_time( end ), [this, corePointer, operation, programIndex, end](){
+            finish_IO( *corePointer, operation, programIndex, end );
+        });
+    }
+}
+
+/* Hand out the channels of the limited devices at the end of a window. The requests of
+* every core and the channels that free up in the window are taken in the order of their
+* simulated times, as a single core would have seen them. This is exact as long as no
+* operation is shorter than the window, which load_config() makes sure of, so every
+* operation started here ends in a later window
+* @param windowEnd = end of the window the cores just finished
+*/
+void Simulator::schedule_devices( const std::chrono::nanoseconds windowEnd )
+{
+    // cores are appended in order and each made its requests in time order, so a stable
+    // sort breaks ties between cores by their number
+    std::vector<IORequest> requests;
+    for( std::unique_ptr<Core> &core : cores_ )
+    {
+        requests.insert( requests.end(), core->ioRequests.begin(), core->ioRequests.end() );
+        core->ioRequests.clear();
+    }
+    std::stable_sort( requests.begin(), requests.end(), []( const IORequest& left, const IORequest& right ){
+        return left.time < right.time;
+    });
+
+    // the barrier logs on the ring of the I/O wheel, which virtual-time mode doesn't use
+    const int producer = static_cast<int>( cores_.size() );
+    std::size_t next = 0;
+    while( true )
+    {
+        const bool release = !deviceReleases_.empty() && deviceReleases_.top().first < windowEnd;
+        if( release && ( next == requests.size() || deviceReleases_.top().first <= requests[next].time ) )
+        {
+            const std::chrono::nanoseconds now = deviceReleases_.top().first;
+            const int device = deviceReleases_.top().second;
+            deviceReleases_.pop();
+            IORequest waiting;
+            if( devices_[device].release( now, waiting ) )
+            {
+                dispatch_IO( waiting, std::max( now, waiting.time ), producer );
+            }
+        }
+        else if( next < requests.size() )
+        {
+            IORequest &request = requests[next++];
+            if( devices_[request.operation.device].request( request ) )
+            {
+                dispatch_IO( request, request.time, producer );
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+/* Announce that an I/O operation is starting
+* @param core = core the program was running on
+* @param request = I/O operation that is starting, and when it was asked for
+* @param start = simulated time it starts at
+* @param producer = log ring and metrics shard of the calling thread
+*/
+void Simulator::begin_IO( Core &core, const IORequest& request, const std::chrono::nanoseconds start,
+    const int producer )
+{
+    const Operation &operation = request.operation;
+    print_IO( core, IO_START, operation, programs_[request.programIndex].id, producer, start );
+    if( metrics_ )
+    {
+        metrics_->io( producer, operation.device, request.time, start,
+            start + std::chrono::microseconds( request.duration ) );
+    }
+}
+
+/* Move a program to another state, charging the time since its last transition to the
+* state it leaves. Only the thread that owns the program at the time may do this
+* @param core = core whose clock the transition happens by
+* @param program = program that changes state
+* @param state = new state
+*/
+void Simulator::set_state( Core &core, Program &program, const State state )
+{
+    if( metrics_ )
+    {
+        ProgramMetrics &metrics = program.metrics;
+        const std::chrono::nanoseconds now = elapsed( core );
+        const std::chrono::nanoseconds spent = now - metrics.lastTransition;
+        switch( program.state )
+        {
+        case READY:
+            metrics.ready += spent;
+            break;
+        case RUNNING:
+            metrics.running += spent;
+            break;
+        case BLOCKED:
+            metrics.blocked += spent;
+            break;
+        default:
+            break;
+        }
+        metrics.lastTransition = now;
+        if( state == RUNNING )
+        {
+            metrics.dispatches++;
+            if( metrics.firstRun.count() < 0 )
+            {
+                metrics.firstRun = now;
+            }
+        }
+    }
+    program.state = state;
+}
+
+/* Announce that an I/O operation is done and interrupt the core that started it, then
+* start the next request waiting for its device. Runs on the I/O wheel's thread in real-time
+* mode, so it must not touch the core's clock; the time the operation ended is given instead
+* @param core = core the program was running on
+* @param operation = I/O operation that finished
+* @param programIndex = index in programs_ of the program which requested the I/O
+* @param end = simulated time the operation ended at
+*/
+void Simulator::finish_IO( Core &core, const Operation& operation, const int programIndex,
+    const std::chrono::nanoseconds end )
+{
+    // the program is blocked, so nothing else touches its PCB while this reads the id
+    const int programID = programs_[programIndex].id;
+    const int producer = clockMode_ == REAL_TIME ? static_cast<int>( cores_.size() ) : core.id;
+    print_IO( core, IO_END, operation, programID, producer, end );
+    Interrupt interrupt( programIndex );
+    if( hostStatistics_ )
+    {
+        interrupt.sent = HostStats::Clock::now();
+    }
+    core.interrupts.push( interrupt );
+
+    // the channel goes to the next request waiting for the device, with several
+    // virtual-time cores schedule_devices() hands it out instead
+    DeviceChannels &device = devices_[operation.device];
+    if( device.limited() && ( clockMode_ == REAL_TIME || cores_.size() == 1 ) )
+    {
+        IORequest waiting;
+        bool next;
+        {
+            std::lock_guard<std::mutex> lock( devicesMutex_ );
+            next = device.release( end, waiting );
+        }
+        if( next )
+        {
+            dispatch_IO( waiting, std::max( end, waiting.time ), producer );
+        }
+    }
+}
+
+/* Run cycles of a processing operation. Between cycles the program may be interrupted,
+* so the cycles stop where that could happen: virtual-time mode stops at the cycle the
+* next I/O completes in, and with a preemptive policy at the cycle the next program
+* arrives in. Real-time mode sleeps through the cycles at once and wakes up early for
+* an interrupt, the cycle in progress then still runs to its end
+* @param core = core the operation runs on
+* @param operation = processing operation, its cycles are used up
+* @param count = cycles to run at most, no more than the operation has left
+* @return number of cycles that ran, at least one
+*/
+template<class Policy>
+int Simulator::run_cycles( Core &core, Operation& operation, int count )
+{
+    const int cycleTimeUsec = cycleTimes_.cycle_time( operation );
+    const std::chrono::microseconds cycleTime( cycleTimeUsec );
+
+    // cycles from the core's clock to the end of the cycle that time falls in
+    auto cycles_until = [&core, cycleTime]( const std::chrono::nanoseconds time ){
+        return time <= core.time ? 1LL : ( time - core.time + cycleTime - std::chrono::nanoseconds( 1 ) ) / cycleTime;
+    };
+    if( cycleTime.count() == 0 )
+    {
+        count = 1;
+    }
+    else
+    {
+        const long long nextArrival = nextArrival_;
+        if( ready_queue<Policy>( core ).preemptive() && nextArrival != NO_ARRIVAL &&
+            ( !Policy::VIRTUAL || cores_.size() == 1 ) )
+        {
+            count = static_cast<int>( std::min<long long>( count, 
+                cycles_until( std::chrono::milliseconds( nextArrival ) ) ) );
+        }
+        if( Policy::VIRTUAL && !core.events.empty() )
+        {
+            count = static_cast<int>( std::min<long long>( count, cycles_until( core.events.top().time ) ) );
+        }
+    }
+
+    if( Policy::VIRTUAL )
+    {
+        advance_clock( core, core.time + std::chrono::microseconds( operation.run( count, cycleTimeUsec ) ) );
+        return count;
+    }
+
+    if( !sleep_until( core, core.time + cycleTime * count, true ) )
+    {
+        count = static_cast<int>( std::min<long long>( count, cycles_until( elapsed<Policy>( core ) ) ) );
+        sleep_until( core, core.time + cycleTime * count, false );
+    }
+    core.time += std::chrono::microseconds( operation.run( count, cycleTimeUsec ) );
+    return count;
+}
+
+/* Sleep most of the way to a deadline and spin the rest, the host wakes threads up
+* later than asked, often by more than a short cycle
+* @param core = core that sleeps, its interrupts can wake it
+* @param time = simulated time to sleep until
+* @param interruptible = whether an interrupt ends the sleep
+* @return false if an interrupt ended the sleep
+*/
+bool Simulator::sleep_until( Core &core, const std::chrono::nanoseconds time, const bool interruptible )
+{
+    const std::chrono::steady_clock::time_point deadline = host_time( time );
+    if( interruptible )
+    {
+        core.interrupts.wait_until( deadline - spinThreshold_ );
+    }
+    else
+    {
+        std::this_thread::sleep_until( deadline - spinThreshold_ );
+    }
+
+    std::chrono::steady_clock::time_point now;
+    while( ( now = std::chrono::steady_clock::now() ) < deadline )
+    {
+        if( interruptible && !core.interrupts.empty() )
+        {
+            return false;
+        }
+    }
+    if( hostStatistics_ )
+    {
+        core.hostStats.sleepOvershoot.record( now - deadline );
+    }
+    return true;
+}
+
+/* Convert a simulated time to the host time it is reached at, real-time mode only
+* @param time = simulated time since the start
+* @return point on the host's monotonic clock
+*/
+std::chrono::steady_clock::time_point Simulator::host_time( const std::chrono::nanoseconds time ) const
+{
+    return start_ + std::chrono::nanoseconds( static_cast<long long>( time.count() / speed_ ) );
+}
+
+/* Move a core's simulated clock forward. Every I/O event that is due before the new time
+* is fired in order, with the clock set to the event's own time while it is handled
+* @param core = core whose clock moves
+* @param time = new simulated time
+*/
+void Simulator::advance_clock( Core &core, const std::chrono::nanoseconds time )
+{
+    while( !core.events.empty() && core.events.top().time <= time )
+    {
+        IOEvent event = core.events.top();
+        core.events.pop();
+        core.time = event.time;
+        finish_IO( core, event.operation, event.programIndex, event.time );
+    }
+    core.time = time;
+}
+
+/* Logs OS action to file, screen, or both, with elapsed time
+* Only queues the record, the logger formats and writes it on its own thread
+* @param core = core the action happened on
+* @param event = action to log
+* @param programID = process the action is about, if any
+* @param value = detail of the action, if it has any
+*/
+void Simulator::print( Core &core, const EventCode event, const int processID, const int value )
+{
+    LogRecord record = core_record( core, event, processID, value );
+    log( record, core.time, core.id );
+}
+
+/* Logs OS action of a core from its own loop. Without a log nothing is done at all,
+* otherwise the record goes straight to the core's ring
+* @param core = core the action happened on
+* @param event = action to log
+* @param programID = process the action is about, if any
+* @param value = detail of the action, if it has any
+*/
+template<class Policy>
+void Simulator::print( Core &core, const EventCode event, const int processID, const int value )
+{
+    if( !Policy::LOGGED )
+    {
+        return;
+    }
+    LogRecord record = core_record( core, event, processID, value );
+    stamp( record, core.time, Policy::VIRTUAL );
+    logger_->log( core.id, record );
+}
+
+/* Record of an OS action of a core, not stamped with a time yet
+* @param core = core the action happened on
+* @param event = action to log
+* @param programID = process the action is about, if any
+* @param value = detail of the action, if it has any
+*/
+LogRecord Simulator::core_record( const Core &core, const EventCode event, const int processID,
+    const int value ) const
+{
+    LogRecord record;
+    record.processID = processID;
+    record.event = event;
+    record.device = NO_DEVICE;
+    record.input = false;
+    record.cpu = cores_.size() > 1 ? core.id + 1 : 0;
+    record.value = value;
+    return record;
+}
+
+/* Logs an event that isn't about any particular core, while no core is running
+* In virtual-time mode it is stamped with the time of the core that got the furthest
+* @param event = action to log
+*/
+void Simulator::print_system( const EventCode event )
+{
+    Core *latest = cores_[0].get();
+    for( std::unique_ptr<Core> &core : cores_ )
+    {
+        if( core->time > latest->time )
+        {
+            latest = core.get();
+        }
+    }
+
+    LogRecord record;
+    record.processID = 0;
+    record.event = event;
+    record.device = NO_DEVICE;
+    record.input = false;
+    record.cpu = 0;
+    record.value = 0;
+    log( record, latest->time, 0 );
+}
+
+/* Logs an I/O event, naming the device and the direction of the operation
+* @param core = core the program was running on
+* @param event = IO_START or IO_END
+* @param operation = I/O operation the event is about
+* @param programID = process which requested the I/O
+* @param producer = log ring of the calling thread
+* @param time = simulated time of the event. In real-time mode too, since the I/O wheel's
+* thread logs the end when the operation's deadline is reached, not when it gets to run
+*/
+void Simulator::print_IO( Core &core, const EventCode event, const Operation& operation,
+    const int processID, const int producer, const std::chrono::nanoseconds time )
+{
+    LogRecord record;
+    record.processID = processID;
+    record.event = event;
+    record.device = operation.device;
+    record.input = operation.type == 'I';
+    record.cpu = cores_.size() > 1 ? core.id + 1 : 0;
+    record.value = 0;
+    if( logger_ )
+    {
+        stamp( record, time, true );
+        logger_->log( producer, record );
+    }
+}
+
+/* Stamps a record with the simulated and the real elapsed time, then queues it
+* @param record to log
+* @param time = simulated time of the record, used in virtual-time mode
+* @param producer = log ring of the calling thread
+*/
+void Simulator::log( LogRecord& record, const std::chrono::nanoseconds time, const int producer )
+{
+    if( !logger_ )
+    {
+        return;
+    }
+    stamp( record, time, clockMode_ == VIRTUAL_TIME );
+    logger_->log( producer, record );
+}
+
+/* Stamps a record with the real elapsed time, and the simulated time it happened at
+* @param record to stamp
+* @param time = simulated time of the record, if it is given
+* @param simulated = whether time is given, otherwise the simulated time follows the
+* real one, as in real-time mode
+*/
+void Simulator::stamp( LogRecord& record, const std::chrono::nanoseconds time, const bool simulated ) const
+{
+    record.wallTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start_ ).count();
+    record.time = simulated ? std::chrono::duration_cast<std::chrono::microseconds>( time ).count()
+        : static_cast<long long>( record.wallTime * speed_ );
+}
+
+/* Writes how many deadlines were missed in the last run, if any program had one, the
+* host overhead if it was measured, the waits of devices with limited channels, and how
+* busy every core was, only done when more than one CPU was simulated
+* @param out = stream to write to
+*/
+void Simulator::print_statistics( std::ostream& out ) const
+{
+    char buffer[160];
+    if( summary_.deadlineJobs > 0 )
+    {
+        std::snprintf( buffer, sizeof(buffer),
+            "Deadlines: %llu of %llu jobs missed, tardiness %.6f s in total, %.6f s at most\n",
+            summary_.deadlineMisses, summary_.deadlineJobs, 
+            std::chrono::duration<double>( summary_.tardiness ).count(),
+            std::chrono::duration<double>( summary_.maxTardiness ).count() );
+        out << buffer;
+    }
+
+    if( hostStatistics_ )
+    {
+        HostStats total;
+        for( const std::unique_ptr<Core> &core : cores_ )
+        {
+            total.merge( core->hostStats );
+        }
+        total.write( out );
+    }
+
+    for( int device = HARD_DRIVE; device < static_cast<int>( devices_.size() ); device++ )
+    {
+        if( devices_[device].limited() )
+        {
+            devices_[device].write( out, static_cast<Device>( device ), summary_.elapsed );
+        }
+    }
+
+    if( cores_.size() <= 1 )
+    {
+        return;
+    }
+
+    const std::chrono::nanoseconds total = summary_.elapsed;
+
+    for( const std::unique_ptr<Core> &core : cores_ )
+    {
+        const double busy = std::chrono::duration<double>( core->busyTime ).count();
+        const double share = total.count() > 0 ? 
+            100.0 * core->busyTime.count() / total.count() : 0.0;
+        std::snprintf( buffer, sizeof(buffer),
+            "CPU %d: %llu dispatches, %llu stolen, busy %.6f s (%.1f%%)\n",
+            core->id + 1, core->dispatches, core->steals, busy, share );
+        out << buffer;
+    }
+}
+
+/* Elapsed time getter
+* @param core = core whose clock is used in virtual-time mode
+* @return simulated time in virtual-time mode, wall clock time scaled by the speed otherwise
+*/
+std::chrono::nanoseconds Simulator::elapsed( const Core &core ) const
+{
+    if( clockMode_ == VIRTUAL_TIME )
+    {
+        return core.time;
+    }
+    const std::chrono::nanoseconds host = std::chrono::duration_cast<std::chrono::nanoseconds>( 
+        std::chrono::steady_clock::now() - start_ );
+    return std::chrono::nanoseconds( static_cast<long long>( host.count() * speed_ ) );
+}
+
+/* Elapsed time getter for a core loop, which knows its clock mode
+* @param core = core whose clock is used in virtual-time mode
+*/
+template<class Policy>
+std::chrono::nanoseconds Simulator::elapsed( const Core &core ) const
+{
+    if( Policy::VIRTUAL )
+    {
+        return core.time;
+    }
+    const std::chrono::nanoseconds host = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start_ );
+    return std::chrono::nanoseconds( static_cast<long long>( host.count() * speed_ ) );
+}
+
+/* Loads data from the config file
+* @param fin = stream of the config file
+* @except Throws exception if the file format isn't correct
+*/
+void Simulator::load_config( std::istream& fin )
+{
+    // make sure the first line of the config file is correct
+    std::string configFormatLine;
+    std::getline(fin, configFormatLine, '\n');
+    if( configFormatLine != "Start Simulator Configuration File" )
+    {
+        throw std::runtime_error( "Error: Incorrect config file format\n" );
+    }
+
+    // ignoring everything up to the ':' 
+    auto limit = std::numeric_limits<std::streamsize>::max();
+    fin.ignore( limit, ':' );
+
+    // make sure the configuration file is for the correct simulator version
+    float simVersion;
+    fin >> simVersion;
+    if( simVersion != simulatorVersion_ )
+    {
+        std::cerr << std::endl 
+            << "Warning: Wrong simulator version." << std::endl            
+            << "Expected: " << simulatorVersion_ << std::endl
+            << "Given: " <<  simVersion << std::endl
+            << "The only reason this doesn't immediately end the program is because the provided \
+            test configuration file has its version set to 2.0 instead of 3.0." << std::endl 
+            << std::endl;
+    }
+    fin.ignore( limit, ':' );
+
+    // get the rest of the data from the config file
+    fin >> metaDataFilePath_;
+    fin.ignore( limit, ':' );
+
+    fin >> schedulingCode_;
+    fin.ignore( limit, ':' );
+    if( !SchedulerRegistry::contains( schedulingCode_ ) )
+    {
+        throw std::runtime_error( "Error: Unrecognized scheduling code\n" );
+    }
+
+    fin >> quantum_;
+
+    processorCycleTime_ = read_cycle_time( fin );
+    monitorDisplayTime_ = read_cycle_time( fin );
+    hardDriveCycleTime_ = read_cycle_time( fin );
+    printerCycleTime_ = read_cycle_time( fin );
+    keyboardCycleTime_ = read_cycle_time( fin );
+    fin.ignore( limit, ':' );
+
+    cycleTimes_.processor = processorCycleTime_;
+    cycleTimes_.device[HARD_DRIVE] = hardDriveCycleTime_;
+    cycleTimes_.device[KEYBOARD] = keyboardCycleTime_;
+    cycleTimes_.device[MONITOR] = monitorDisplayTime_;
+    cycleTimes_.device[PRINTER] = printerCycleTime_;
+
+    std::string logString;
+    fin >> std::ws; // ignore the space after :
+    std::getline(fin, logString, '\n');
+
+    // transform the log location to enum for easier processing later
+    if( logString == "Log to Both")
+    {
+        logLocation_ = BOTH;
+    }
+    else if( logString == "Log to File" )
+    {
+        logLocation_ = FILE;
+    }
+    else if( logString == "Log to Binary" )
+    {
+        logLocation_ = BINARY;
+    }
+    else if( logString == "Log to Chrome Trace" )
+    {
+        logLocation_ = CHROME_TRACE;
+    }
+    else if( logString == "Log to None" )
+    {
+        logLocation_ = NONE;
+    }
+    else
+    {
+        logLocation_ = SCREEN;
+    }
+    fin.ignore( limit, ':' );
+
+    fin >> logFilePath_;
+    fin >> std::ws;
+
+    // optional settings, one per line, until the end of the config file
+    while( std::getline(fin, configFormatLine, '\n') && configFormatLine.compare(0, 3, "End") != 0 )
+    {
+        load_optional_setting( configFormatLine );
+        fin >> std::ws;
+    }
+
+    // make sure the config file ends here
+    if( configFormatLine.compare(0, 3, "End") != 0 )
+    {
+        throw std::runtime_error( "Error: Incorrect config file format\n" );
+    }
+
+    // cores meet once per quantum by default
+    if( syncWindow_ == 0 )
+    {
+        syncWindow_ = std::max( 1LL, static_cast<long long>( quantum_ ) * processorCycleTime_ );
+    }
+
+    // the disk model needs a queue, so a modelled hard drive serves one operation at a time
+    // unless told otherwise. Ordering by position only works with a model
+    if( diskCylinders_ > 0 )
+    {
+        disk_ = DiskModel( diskCylinders_, diskBlocksPerCylinder_, diskTrackSeek_,
+            std::max( diskFullSeek_, diskTrackSeek_ ), diskRpm_ );
+        if( deviceChannels_[HARD_DRIVE] == 0 )
+        {
+            deviceChannels_[HARD_DRIVE] = 1;
+        }
+    }
+    else if( deviceQueues_[HARD_DRIVE] != DeviceChannels::FIFO && deviceQueues_[HARD_DRIVE] != DeviceChannels::SJF )
+    {
+        throw std::runtime_error( "Error: SSTF, SCAN and C-LOOK need the Hard Drive Cylinders setting\n" );
+    }
+
+    // devices with limited channels are shared by the cores, which only meet at the
+    // barrier, so a window may be no longer than a cycle of them, see schedule_devices()
+    if( clockMode_ == VIRTUAL_TIME && cpuCount_ > 1 )
+    {
+        for( int device = HARD_DRIVE; device < DEVICE_COUNT; device++ )
+        {
+            if( deviceChannels_[device] > 0 && cycleTimes_.device[device] > 0 )
+            {
+                syncWindow_ = std::min<long long>( syncWindow_, cycleTimes_.device[device] );
+            }
+        }
+    }
+
+    // let the policy check its settings now rather than when the run starts
+    schedulerSettings_.programs = &programs_;
+    schedulerSettings_.quantum = quantum_;
+    schedulerSettings_.processorCycleTime = processorCycleTime_;
+    SchedulerRegistry::create( schedulingCode_, schedulerSettings_ );
+}
+
+/* Reads a cycle time line of the config. The unit is the one in parentheses in its name,
+* msec or usec, and msec if there is none. Times are kept in usec, the resolution of the log
+* @param fin = stream of the config file, at the start of the line's name
+* @return cycle time in usec
+* @except Throws exception if the unit is unknown or the time doesn't fit
+*/
+int Simulator::read_cycle_time( std::istream& fin )
+{
+    std::string name;
+    std::getline( fin, name, ':' );
+    long long time = 0;
+    fin >> time;
+
+    std::string unit = "msec";
+    const std::size_t open = name.rfind( '(' );
+    const std::size_t close = name.rfind( ')' );
+    if( open != std::string::npos && close != std::string::npos && close > open )
+    {
+        unit = name.substr( open + 1, close - open - 1 );
+    }
+
+    if( time < 0 )
+    {
+        throw std::runtime_error( "Error: Cycle times can't be negative\n" );
+    }
+    if( unit == "msec" || unit == "ms" )
+    {
+        time *= 1000;
+    }
+    else if( unit != "usec" && unit != "us" && unit != "\u00b5s" )
+    {
+        throw std::runtime_error( "Error: Unrecognized time unit " + unit + "\n" );
+    }
+    if( time > std::numeric_limits<int>::max() )
+    {
+        throw std::runtime_error( "Error: Cycle times can't be longer than 2147 seconds\n" );
+    }
+    return static_cast<int>( time );
+}
+
+/* Parses an optional config setting
+* @param line from the config file, formatted as "Name: value"
+* @except Throws exception if the line isn't a recognized setting
+*/
+void Simulator::load_optional_setting( const std::string& line )
+{
+    std::size_t colonLocation = line.find(':');
+    if( colonLocation == std::string::npos )
+    {
+        throw std::runtime_error( "Error: Incorrect config file format\n" );
+    }
+
+    std::string name = line.substr(0, colonLocation);
+    std::string value = line.substr(colonLocation + 1);
+    value.erase(0, value.find_first_not_of(" \t"));
+    value.erase(value.find_last_not_of(" \t\r") + 1);
+
+    if( name == "Simulation Clock" )
+    {
+        if( value == "Virtual" )
+        {
+            clockMode_ = VIRTUAL_TIME;
+        }
+        else if( value == "Real" )
+        {
+            clockMode_ = REAL_TIME;
+        }
+        else
+        {
+            throw std::runtime_error( "Error: Unrecognized simulation clock\n" );
+        }
+    }
+    else if( name == "Log Overflow" )
+    {
+        if( value == "Block" )
+        {
+            logOverflow_ = Logger::BLOCK;
+        }
+        else if( value == "Drop" )
+        {
+            logOverflow_ = Logger::DROP;
+        }
+        else
+        {
+            throw std::runtime_error( "Error: Unrecognized log overflow policy\n" );
+        }
+    }
+    else if( name == "Log Buffer Size (records)" )
+    {
+        int size = std::stoi( value );
+        if( size <= 0 )
+        {
+            throw std::runtime_error( "Error: Log buffer size must be positive\n" );
+        }
+        logBufferSize_ = size;
+    }
+    else if( name == "CPU Count" )
+    {
+        int count = std::stoi( value );
+        if( count <= 0 || count > 255 )
+        {
+            throw std::runtime_error( "Error: CPU count must be between 1 and 255\n" );
+        }
+        cpuCount_ = count;
+    }
+    else if( name == "CPU Sync Window (msec)" )
+    {
+        int window = std::stoi( value );
+        if( window <= 0 )
+        {
+            throw std::runtime_error( "Error: CPU sync window must be positive\n" );
+        }
+        syncWindow_ = window * 1000LL;
+    }
+    else if( name == "Metrics File Path" )
+    {
+        metricsFilePath_ = value;
+    }
+    else if( name == "Metrics Format" )
+    {
+        if( value == "JSON" )
+        {
+            metricsFormat_ = MetricsCollector::JSON;
+        }
+        else if( value == "CSV" )
+        {
+            metricsFormat_ = MetricsCollector::CSV;
+        }
+        else
+        {
+            throw std::runtime_error( "Error: Unrecognized metrics format\n" );
+        }
+    }
+    else if( name == "Simulation Speed" )
+    {
+        // a factor such as 10 or 0.5, optionally written as 10x
+        std::size_t length = 0;
+        double speed = 0;
+        try
+        {
+            speed = std::stod( value, &length );
+        }
+        catch( const std::logic_error& )
+        {
+        }
+        if( length > 0 && length + 1 == value.size() && ( value.back() == 'x' || value.back() == 'X' ) )
+        {
+            length++;
+        }
+        if( length == 0 || length != value.size() || !( speed > 0 && speed < std::numeric_limits<double>::infinity() ) )
+        {
+            throw std::runtime_error( "Error: Simulation speed must be a positive factor\n" );
+        }
+        speed_ = speed;
+    }
+    else if( name == "Spin Threshold (usec)" )
+    {
+        int threshold = std::stoi( value );
+        if( threshold < 0 )
+        {
+            throw std::runtime_error( "Error: Spin threshold can't be negative\n" );
+        }
+        spinThreshold_ = std::chrono::microseconds( threshold );
+    }
+    else if( name == "Host Statistics" )
+    {
+        if( value == "On" )
+        {
+            hostStatistics_ = true;
+        }
+        else if( value == "Off" )
+        {
+            hostStatistics_ = false;
+        }
+        else
+        {
+            throw std::runtime_error( "Error: Unrecognized host statistics setting\n" );
+        }
+    }
+    else if( device_setting( name, " Channels" ) != NO_DEVICE )
+    {
+        // such as "Printer Channels: 2", "Unlimited" is the default
+        const Device device = device_setting( name, " Channels" );
+        int channels = 0;
+        if( value != "Unlimited" )
+        {
+            channels = std::stoi( value );
+            if( channels <= 0 )
+            {
+                throw std::runtime_error( "Error: Device channels must be positive\n" );
+            }
+        }
+        deviceChannels_[device] = channels;
+    }
+    else if( device_setting( name, " Queue" ) != NO_DEVICE )
+    {
+        const Device device = device_setting( name, " Queue" );
+        if( value == "FIFO" || value == "FCFS" )
+        {
+            deviceQueues_[device] = DeviceChannels::FIFO;
+        }
+        else if( value == "SJF" )
+        {
+            deviceQueues_[device] = DeviceChannels::SJF;
+        }
+        else if( device == HARD_DRIVE && value == "SSTF" )
+        {
+            deviceQueues_[device] = DeviceChannels::SSTF;
+        }
+        else if( device == HARD_DRIVE && value == "SCAN" )
+        {
+            deviceQueues_[device] = DeviceChannels::SCAN;
+        }
+        else if( device == HARD_DRIVE && value == "C-LOOK" )
+        {
+            deviceQueues_[device] = DeviceChannels::C_LOOK;
+        }
+        else
+        {
+            throw std::runtime_error( "Error: Unrecognized device queue discipline\n" );
+        }
+    }
+    else if( name == "Hard Drive Cylinders" )
+    {
+        diskCylinders_ = std::stoi( value );
+        if( diskCylinders_ <= 0 )
+        {
+            throw std::runtime_error( "Error: Hard drive cylinders must be positive\n" );
+        }
+    }
+    else if( name == "Hard Drive Blocks per Cylinder" )
+    {
+        diskBlocksPerCylinder_ = std::stoi( value );
+        if( diskBlocksPerCylinder_ <= 0 )
+        {
+            throw std::runtime_error( "Error: Hard drive blocks per cylinder must be positive\n" );
+        }
+    }
+    else if( name == "Hard Drive Track Seek (usec)" || name == "Hard Drive Full Seek (msec)" )
+    {
+        const int seek = std::stoi( value );
+        if( seek < 0 )
+        {
+            throw std::runtime_error( "Error: Hard drive seek times can't be negative\n" );
+        }
+        if( name == "Hard Drive Track Seek (usec)" )
+        {
+            diskTrackSeek_ = seek;
+        }
+        else
+        {
+            diskFullSeek_ = seek * 1000LL;
+        }
+    }
+    else if( name == "Hard Drive RPM" )
+    {
+        diskRpm_ = std::stoi( value );
+        if( diskRpm_ < 0 )
+        {
+            throw std::runtime_error( "Error: Hard drive RPM can't be negative\n" );
+        }
+    }
+    else if( name == "Admission Look-Ahead (programs)" )
+    {
+        int lookAhead = std::stoi( value );
+        if( lookAhead < 0 )
+        {
+            throw std::runtime_error( "Error: Admission look-ahead can't be negative\n" );
+        }
+        admissionLookAhead_ = lookAhead;
+    }
+    else if( SchedulerRegistry::accepts_setting( name ) )
+    {
+        // checked by the scheduling policy
+        schedulerSettings_.options[name] = value;
+    }
+    else
+    {
+        throw std::runtime_error( "Error: Unrecognized config setting " + name + "\n" );
+    }
+}
+
+/* Find the device a per-device setting is about, its name is the device's followed by
+* the kind of setting, as in "Hard Drive Channels"
+* @param name = name of the setting
+* @param suffix = kind of setting, with its leading space
+* @return device of the setting, NO_DEVICE if it isn't one of this kind
+*/
+Device Simulator::device_setting( const std::string& name, const std::string& suffix )
+{
+    if( name.size() <= suffix.size() || name.compare( name.size() - suffix.size(), suffix.size(), suffix ) != 0 )
+    {
+        return NO_DEVICE;
+    }
+    std::string device = name.substr( 0, name.size() - suffix.size() );
+    for( char &c : device )
+    {
+        c = static_cast<char>( std::tolower( static_cast<unsigned char>( c ) ) );
+    }
+    return device_from_name( device );
+}
+
+/* Opens the meta-data file and reads programs from it. Every program is read up front
+* unless an admission look-ahead is set, then only that many are read ahead of their
+* arrival and the rest is streamed in while the simulation runs
+* A precompiled workload is used as is instead of being parsed, and a shared workload
+* replaces the file altogether
+* @param file path for the meta data file
+*/
+void Simulator::load_meta_data( const std::string filePath )
+{
+    if( workload_ )
+    {
+        // already read by whoever shares it
+    }
+    else if( is_workload_snapshot( filePath ) )
+    {
+        snapshot_.reset( new WorkloadSnapshot( filePath ) );
+        const SnapshotHeader &header = snapshot_->header();
+        if( header.processorCycleTime != processorCycleTime_ ||
+            header.monitorDisplayTime != monitorDisplayTime_ ||
+            header.hardDriveCycleTime != hardDriveCycleTime_ ||
+            header.printerCycleTime != printerCycleTime_ ||
+            header.keyboardCycleTime != keyboardCycleTime_ )
+        {
+            std::cerr << "Warning: " << filePath << " was compiled with different cycle times, "
+                << "the compiled ones are used" << std::endl;
+        }
+
+        // the remaining times of the programs were added up with these
+        cycleTimes_.processor = header.processorCycleTime;
+        cycleTimes_.device[HARD_DRIVE] = header.hardDriveCycleTime;
+        cycleTimes_.device[KEYBOARD] = header.keyboardCycleTime;
+        cycleTimes_.device[MONITOR] = header.monitorDisplayTime;
+        cycleTimes_.device[PRINTER] = header.printerCycleTime;
+    }
+    else
+    {
+        reader_.reset( new MetaDataReader( filePath ) );
+    }
+
+    if( admissionLookAhead_ == 0 )
+    {
+        while( read_next_program() );
+    }
+    else
+    {
+        while( arrivals_.size() < admissionLookAhead_ && read_next_program() );
+    }
+    update_next_arrival();
+}
+
+/* Reads the next program of the workload into a free slot of the PCB table
+* Programs from a snapshot point straight into the mapped file, so no operation is
+* touched until it runs
+* @return false if there are no more programs
+* @except Throws exception if the meta-data file format isn't correct
+*/
+bool Simulator::read_next_program()
+{
+    if( workloadDone_ )
+    {
+        return false;
+    }
+
+    // a finished program's slot is reused, operations included, before the table grows
+    int programIndex = -1;
+    std::vector<Operation> operations;
+    if( !freePrograms_.empty() )
+    {
+        programIndex = freePrograms_.back();
+        operations.swap( programOperations_[programIndex] );
+    }
+
+    Program program;
+    if( snapshot_ )
+    {
+        workloadDone_ = workloadPosition_ == snapshot_->header().programCount;
+        if( !workloadDone_ )
+        {
+            const SnapshotProgram &entry = snapshot_->programs()[workloadPosition_++];
+            program = Program( snapshot_->operations() + entry.firstOperation, 
+                entry.operationCount, entry.remainingTime, &cycleTimes_ );
+            program.attributes = entry.attributes;
+        }
+    }
+    else if( workload_ )
+    {
+        // the shared operations have no cycle times, the program times them with ours
+        workloadDone_ = workloadPosition_ == workload_->programs().size();
+        if( !workloadDone_ )
+        {
+            const Workload::Entry &entry = workload_->programs()[workloadPosition_++];
+            const Operation* first = workload_->operations() + entry.firstOperation;
+            program = Program( first, entry.operationCount, 
+                program_time( first, entry.operationCount ), &cycleTimes_ );
+            program.attributes = entry.attributes;
         }
-        
-        else if( operation.description == "keyboard" )
+    }
+    else
+    {
+        ProgramAttributes attributes;
+        workloadDone_ = !reader_->next_program( operations, attributes );
+        if( !workloadDone_ )
         {
-            operation.cycleTime = keyboardCycleTime_;
+            // moving the vector into the table later keeps its storage where it is
+            program = Program( operations.data(), operations.size(), 
+                program_time( operations.data(), operations.size() ), &cycleTimes_ );
+            program.attributes = attributes;
         }
-        else if( operation.description == "monitor" )
+    }
+
+    if( workloadDone_ )
+    {
+        if( programIndex >= 0 )
         {
-            operation.cycleTime = monitorDisplayTime_;
+            operations.swap( programOperations_[programIndex] );
         }
+        reader_.reset();
+        return false;
+    }
+
+    if( program.attributes.arrival < lastArrival_ )
+    {
+        throw std::runtime_error( "Error: Incorrect meta-data file format: \
+            programs have to be listed in order of arrival\n" );
+    }
+    lastArrival_ = program.attributes.arrival;
+
+    if( programIndex >= 0 )
+    {
+        freePrograms_.pop_back();
+        programs_[programIndex] = program;
+        programOperations_[programIndex] = std::move( operations );
+    }
+    else
+    {
+        programIndex = programs_.size();
+        programs_.push_back( program );
+        programOperations_.push_back( std::move( operations ) );
+    }
+    arrivals_.push_back( programIndex );
+    return true;
+}
 
-        else if( operation.description == "printer" )
+/* Add up how long a program's operations take with the configured cycle times. Each
+* duration is cycles * cycle time, both ints, so only the total can get out of hand
+* @param operations = first operation of the program
+* @param count = number of operations
+* @return usec
+* @except Throws exception if the program takes longer than the simulated clock, which
+* counts nsec, can hold
+*/
+long long Simulator::program_time( const Operation* operations, const std::size_t count ) const
+{
+    const long long limit = std::chrono::duration_cast<std::chrono::microseconds>( 
+        std::chrono::nanoseconds::max() ).count();
+    long long programTime = 0;
+    for( std::size_t i = 0; i < count; i++ )
+    {
+        const long long duration = cycleTimes_.duration( operations[i] );
+        if( duration > limit - programTime )
         {
-            operation.cycleTime = printerCycleTime_;
+            throw std::runtime_error( "Error: Incorrect meta-data file format: program takes longer than " + 
+                std::to_string( limit / 1000000 ) + " seconds\n" );
         }
+        programTime += duration;
     }
+    return programTime;
+}
 
-    else if( operation.type == 'A' || operation.type == 'S' )
+/* Writes the loaded programs out as a precompiled workload, which can be used in place
+* of the meta-data file to skip parsing it
+* @param file path for the workload snapshot
+*/
+void Simulator::compile( const std::string filePath )
+{
+    SnapshotHeader header;
+    try
+    {
+        // a streamed workload has to be read completely first
+        while( read_next_program() );
+    }
+    catch( const std::runtime_error& e )
     {
-        operation.cycleTime = 0;
+        std::cerr << e.what();
+        throw;
     }
 
-    else throw std::runtime_error( "Error: Unrecognized operation type, \
-        check meta-data file" );
+    header.processorCycleTime = processorCycleTime_;
+    header.monitorDisplayTime = monitorDisplayTime_;
+    header.hardDriveCycleTime = hardDriveCycleTime_;
+    header.printerCycleTime = printerCycleTime_;
+    header.keyboardCycleTime = keyboardCycleTime_;
+    try
+    {
+        write_workload_snapshot( filePath, header, programs_ );
+    }
+    catch( const std::runtime_error& e )
+    {
+        std::cerr << e.what();
+        throw;
+    }
 }
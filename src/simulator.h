@@ -6,20 +6,45 @@
 #ifndef SIMULATOR_H
 #define SIMULATOR_H
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cctype>
 #include <chrono>
+#include <condition_variable>
+#include <cstdio>
 #include <ctime>
+#include <deque>
+#include <exception>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <thread>
 #include <queue>
+#include <set>
+#include <utility>
+#include <vector>
 
+#include "device_channels.h"
+#include "host_stats.h"
+#include "log_record.h"
+#include "logger.h"
+#include "meta_data_reader.h"
+#include "metrics.h"
+#include "mpsc_queue.h"
 #include "operation.h"
 #include "program.h"
+#include "program_table.h"
+#include "scheduler.h"
+#include "timer_wheel.h"
+#include "workload.h"
+#include "workload_snapshot.h"
 
 /* OS Simulator. Loads a configuration file and a program to run */
 class Simulator
@@ -28,37 +53,204 @@ public:
 
     // Constructor loads the config file and initializes Program object
     Simulator( const std::string filePath );
+
+    // Reads the config from a stream and runs a workload that is shared with other
+    // simulators, the config's file path isn't used
+    Simulator( std::istream& config, std::shared_ptr<const Workload> workload );
     ~Simulator();
 
     // Runs the simulation
     void run();
 
+    // Writes the loaded workload to a precompiled file that loads without parsing
+    void compile( const std::string filePath );
+
+    // Totals of a finished run
+    struct Summary
+    {
+        std::chrono::nanoseconds elapsed{ 0 }; // simulated time, or wall clock time in real-time mode
+        int programs = 0;
+        int cpus = 1;
+        unsigned long long dispatches = 0;
+        std::chrono::nanoseconds busyTime{ 0 }; // summed over every CPU
+
+        // Jobs of programs that have a deadline, and how late the ones that missed it were
+        unsigned long long deadlineJobs = 0;
+        unsigned long long deadlineMisses = 0;
+        std::chrono::nanoseconds tardiness{ 0 }; // summed over every missed deadline
+        std::chrono::nanoseconds maxTardiness{ 0 };
+    };
+    const Summary& summary() const;
+
+    // Writes a line per CPU on how busy it was, if more than one was simulated,
+    // how many deadlines were missed, if any program had one, and how long I/O waited
+    // for the devices with a limited number of channels
+    void print_statistics( std::ostream& out ) const;
+
 private:
 
+    struct Core;
+
     /***** Helper functions *****/
 
-    template<typename QueueType>
     void run_helper();
-    template<typename QueueType>
-    Program select_next_program( std::unique_ptr<QueueType> const &readyQueue );
 
-    // Helper function that processes each individual program operation
-    void process_program( Program &program );
+    // The loop every core runs is compiled once per combination of the choices that stay
+    // fixed for a run, and picked by select_core_loop() before the cores start. Queue is
+    // the concrete class of the ready queue, so calls to a built-in policy aren't virtual,
+    // Scheduler for policies added to the registry. VIRTUAL is the clock mode, and LOGGED
+    // is false if nothing is logged, so records aren't even made
+    template<class Q, bool VirtualTime, bool Logged>
+    struct LoopPolicy
+    {
+        typedef Q Queue;
+        static const bool VIRTUAL = VirtualTime;
+        static const bool LOGGED = Logged;
+    };
+    typedef void (Simulator::*CoreLoop)( Core &core );
+    CoreLoop select_core_loop( const Scheduler& queue ) const;
+    template<class Queue> CoreLoop core_loop_for() const;
+
+    // Ready queue of a core as the policy's queue class
+    template<class Policy> static typename Policy::Queue& ready_queue( Core &core );
+
+    template<class Policy> void core_loop( Core &core );
+    int admit_programs( Core &core );
+
+    // Admits the next arrival, needs workloadMutex_
+    int admit_next_program( Core &core );
+    void update_next_arrival();
+
+    // Index of the program that arrives next, read or released again, -1 if there is none.
+    // Needs workloadMutex_
+    int next_arrival() const;
+
+    // Checks the deadline of a program's job that just finished, and releases the
+    // next job of a periodic program. false once the program is done for good
+    bool finish_job( Core &core, const int programIndex );
+
+    // Ready queue access, pushing wakes an idle core so it can steal the program.
+    // The loop of a core uses the versions compiled for its policy
+    void push_ready( Core &core, const int programIndex );
+    template<class Policy> void push_ready( Core &core, const int programIndex );
+    template<class Policy> int take_program( Core &core );
+
+    // Virtual-time mode with several cores: waits for every core to reach the end of the
+    // current window, the last one to arrive admits and balances programs for the next one
+    void synchronize( Core &core );
+
+    // Lets a core that went idle sleep until it has something to do
+    void idle( Core &core );
+
+    // true once every program has arrived and exited, or the run was aborted
+    bool finished() const;
+
+    // Ends the run on every core, after one of them failed
+    void abort( std::exception_ptr error );
+
+    // Interrupts idle cores so they look for work or notice that the run is over
+    void wake_idle_core();
+    void wake_all_cores();
+
+    // Helper function that processes each individual program operation,
+    // a run is interrupted once the quantum of cycles is used up
+    template<class Policy> void process_program( Core &core, const int programIndex, const int quantum );
+
+    // Checked before every cycle of a run: true if the running program has to give up the CPU
+    template<class Policy> bool preempted( Core &core, const int programIndex, const Operation& operation );
+
+    // Queues the program whose I/O interrupt a core took, sent is when the interrupt was posted
+    void io_interrupt( Core &core, const int programIndex, const HostStats::Clock::time_point sent );
+
+    // Asks the operation's device for an I/O operation, which starts it unless every
+    // channel of the device is busy
+    void start_IO( Core &core, const Operation& operation, const int programIndex );
+
+    // Starts a request on a device channel at time start, as a timer on the I/O wheel or
+    // as a simulated completion event. producer is the log ring of the calling thread
+    void dispatch_IO( const IORequest& request, const std::chrono::nanoseconds start, const int producer );
+
+    // Virtual-time mode with several cores: hands out the channels of the shared devices,
+    // for the requests of the window that ends at windowEnd. Needs the barrier
+    void schedule_devices( const std::chrono::nanoseconds windowEnd );
+
+    // Moves a program to another state, and keeps track of the time it spent in each
+    void set_state( Core &core, Program &program, const State state );
+
+    // Announce the beginning and the end of an I/O operation, at the simulated times
+    // they happen
+    void begin_IO( Core &core, const IORequest& request, const std::chrono::nanoseconds start,
+        const int producer );
+    void finish_IO( Core &core, const Operation& operation, const int programIndex,
+        const std::chrono::nanoseconds end );
+
+    // Real-time mode: host time at which the simulation reaches a simulated time
+    std::chrono::steady_clock::time_point host_time( const std::chrono::nanoseconds time ) const;
+
+    // Runs up to count cycles of a processing operation back to back, in real-time mode
+    // with a single sleep. Stops early where something may interrupt the program, after
+    // the cycle in progress. Returns the number of cycles that ran
+    template<class Policy> int run_cycles( Core &core, Operation& operation, int count );
+
+    // Real-time mode: sleeps until the core's simulated clock reaches time, spinning
+    // for the last part. false if an interrupt arrived first, when interruptible
+    bool sleep_until( Core &core, const std::chrono::nanoseconds time, const bool interruptible );
+
+    // Virtual-time mode: moves a core's clock forward, firing every event that falls due on the way
+    void advance_clock( Core &core, const std::chrono::nanoseconds time );
+
+    // Time since the simulation started, simulated or real depending on the clock mode
+    std::chrono::nanoseconds elapsed( const Core &core ) const;
+    template<class Policy> std::chrono::nanoseconds elapsed( const Core &core ) const;
+
+    // Logs current OS action of a core, stamped with the elapsed time
+    void print( Core &core, const EventCode event, const int processID = 0, const int value = 0 );
+    template<class Policy> void print( Core &core, const EventCode event, const int processID = 0,
+        const int value = 0 );
+
+    // Record of a core's OS action, shared by both print()s
+    LogRecord core_record( const Core &core, const EventCode event, const int processID,
+        const int value ) const;
+
+    // Logs an event of the whole simulator rather than of one core
+    void print_system( const EventCode event );
+
+    // Logs the start or end of an I/O operation from the given log producer, at the
+    // simulated time it happens in either clock mode
+    void print_IO( Core &core, const EventCode event, const Operation& operation,
+        const int processID, const int producer, const std::chrono::nanoseconds time );
+
+    // Timestamps a record with a simulated time, or the real one in real-time mode,
+    // and queues it on the producer's ring
+    void log( LogRecord& record, const std::chrono::nanoseconds time, const int producer );
 
-    // Helper function that deals with IO, created in a new thread
-    void process_IO( const Operation& operation, const int programID );
+    // Sets a record's real elapsed time, and its simulated time to the given one or
+    // to the real one scaled by the speed
+    void stamp( LogRecord& record, const std::chrono::nanoseconds time, const bool simulated ) const;
 
-    // Prints elapsed time and current OS action
-    void print( const std::string message );
 
     // Loads all config info (used by constructor)
-    void load_config( const std::string filePath );
+    void load_config( std::istream& fin );
 
-    // fills queue with program's operations
+    // Reads a cycle time line of the config, in the unit its name gives, and returns usec
+    static int read_cycle_time( std::istream& fin );
+
+    // Parses a single "Name: value" line from the optional part of the config file
+    void load_optional_setting( const std::string& line );
+
+    // Device of a setting such as "Hard Drive Channels" with the given suffix, NO_DEVICE otherwise
+    static Device device_setting( const std::string& name, const std::string& suffix );
+
+    // opens the meta-data file, and reads the programs that are needed up front
     void load_meta_data( const std::string filePath );
 
-    // helper function to get proper cycle time
-    void set_operation_cycle_time( Operation &operation );
+    // reads one more program into the PCB table and queues it for arrival,
+    // false once the whole workload was read
+    bool read_next_program();
+
+    // Sum of the durations of a program's operations in usec, throws if it is longer
+    // than the simulated clock can count
+    long long program_time( const Operation* operations, const std::size_t count ) const;
 
 
     /***** Structures *****/
@@ -66,33 +258,138 @@ private:
     // Incredibly simple "Interrupt"
     struct Interrupt
     {
-        Interrupt(int PID = 0) : processID(PID) {}
-        // if an interrupt has PID of 0 then it must have been a quantum interrupt
-        // otherwise, it is an I/O event of specified processID
-        int processID;
+        static const int QUANTUM = -1;
+        static const int WAKEUP = -2;
+        Interrupt(int index = QUANTUM) : programIndex(index) {}
+        // if an interrupt has an index of QUANTUM then it must have been a quantum interrupt,
+        // WAKEUP is sent to an idle core by another one, otherwise it is an I/O event of
+        // the program at that index of programs_
+        int programIndex;
+        HostStats::Clock::time_point sent; // host statistics only: when an I/O interrupt was posted
     };
-    std::queue<Interrupt> interrupts_;
-
-    // All the program's information
-    std::vector<Program> programs_;
 
-    // Currently blocked programs
-    std::map<int,Program> blockedPrograms_; 
-
-    // Scheduling
-    struct FIFOComparator{
-        bool operator()( const Program &left, const Program &right ){
-            return left.id > right.id;
-        }
+    // Virtual-time mode: pending I/O completion, fired once the clock reaches it
+    struct IOEvent
+    {
+        std::chrono::nanoseconds time;
+        unsigned long long sequence; // keeps events with equal times in scheduling order
+        Operation operation;
+        int programIndex;
     };
-    struct SRTFComparator{
-        bool operator()( const Program &left, const Program &right ){
-            return left.remaining_time() > right.remaining_time();
+    struct IOEventComparator{
+        bool operator()( const IOEvent &left, const IOEvent &right ){
+            if( left.time != right.time )
+            {
+                return left.time > right.time;
+            }
+            return left.sequence > right.sequence;
         }
     };
-    using RR_Q = std::queue<Program>;
-    using FIFO_Q = std::priority_queue<Program, std::vector<Program>, FIFOComparator>;
-    using SRTF_Q = std::priority_queue<Program, std::vector<Program>, SRTFComparator>;   
+
+    // A simulated CPU. With more than one, every core runs on its own host thread
+    struct Core
+    {
+        int id = 0;
+
+        // Pushed by the core itself, the I/O wheel's thread and other cores, only the core pops
+        MPSCQueue<Interrupt> interrupts;
+
+        // Guards the core's ready queue, idle cores lock it to steal from it
+        std::mutex queueMutex;
+        std::unique_ptr<Scheduler> readyQueue; // holds indices into programs_
+        std::atomic<int> queued{ 0 }; // programs in the ready queue, read without the lock
+        std::atomic<bool> idle{ false };
+        bool announcedIdle = false;
+
+        // Virtual-time mode: the core's own clock and the I/O completions it waits for.
+        // Real-time mode: time is the simulated time the current cycle ends at
+        std::chrono::nanoseconds time{ 0 };
+        std::priority_queue<IOEvent, std::vector<IOEvent>, IOEventComparator> events;
+        unsigned long long eventCounter = 0;
+
+        // Virtual-time mode with several cores: requests for devices with a limited number
+        // of channels, made during the current window and decided at its end
+        std::vector<IORequest> ioRequests;
+
+        // Statistics
+        std::chrono::nanoseconds busyTime{ 0 };
+        unsigned long long dispatches = 0;
+        unsigned long long steals = 0;
+        int lastProgram = -1; // program dispatched last, to tell context switches apart
+        HostStats hostStats; // histograms are only recorded with host statistics on
+        unsigned long long deadlineJobs = 0;
+        unsigned long long deadlineMisses = 0;
+        std::chrono::nanoseconds tardiness{ 0 };
+        std::chrono::nanoseconds maxTardiness{ 0 };
+    };
+    std::vector<std::unique_ptr<Core>> cores_;
+    std::atomic<int> idleCores_{ 0 };
+
+    // Virtual-time mode with several cores: cores run independently up to windowEnd_,
+    // then meet at a barrier. Only touched by the last core to arrive while the others wait
+    std::mutex barrierMutex_;
+    std::condition_variable barrierWakeup_;
+    int barrierWaiting_ = 0;
+    unsigned long long barrierGeneration_ = 0;
+    std::chrono::nanoseconds windowEnd_{ 0 };
+
+    // Simulated devices, indexed by Device. All cores share them, so they are locked in
+    // real-time mode, with several virtual-time cores only the barrier uses them
+    std::vector<DeviceChannels> devices_;
+    std::mutex devicesMutex_;
+
+    // Virtual-time mode with several cores: times the busy channels of limited devices
+    // free up, with their device, earliest first
+    std::priority_queue<std::pair<std::chrono::nanoseconds, int>, std::vector<std::pair<std::chrono::nanoseconds, int>>,
+        std::greater<std::pair<std::chrono::nanoseconds, int>>> deviceReleases_;
+
+    // Set once every program is done, or a core failed with error_
+    std::atomic<bool> finished_{ false };
+    std::exception_ptr error_;
+
+    // All the program's information. This is the PCB table, every other structure
+    // refers to a program by its index in here. Programs never move, so a core can keep
+    // using its program while another one reads new programs into the table
+    ProgramTable programs_;
+
+    // Guards the workload below: the readers, arrivals_, releases_, freePrograms_ and growing programs_
+    std::mutex workloadMutex_;
+
+    // Where programs are read from, only one of these is used
+    std::unique_ptr<MetaDataReader> reader_;
+    std::unique_ptr<WorkloadSnapshot> snapshot_;
+    std::shared_ptr<const Workload> workload_;
+    std::uint64_t workloadPosition_ = 0; // next program in snapshot_ or workload_
+    bool workloadDone_ = false;
+
+    // Operations of programs read from a meta-data file, indexed like programs_.
+    // Programs from a snapshot point into its mapping instead
+    std::vector<std::vector<Operation>> programOperations_;
+
+    // Slots of programs_ whose program exited, reused for programs that are read later
+    std::vector<int> freePrograms_;
+
+    // Programs that were read but haven't arrived yet, in order of arrival
+    std::deque<int> arrivals_;
+    int lastArrival_ = 0;
+
+    // Periodic programs waiting for the release of their next job, by release time and index.
+    // Kept apart from arrivals_ so the order doesn't depend on which core finished a job first
+    std::set<std::pair<int, int>> releases_;
+
+    // Arrival time of next_arrival() in milliseconds, so cores can check it without the lock
+    static const long long NO_ARRIVAL = std::numeric_limits<long long>::max();
+    std::atomic<long long> nextArrival_{ NO_ARRIVAL };
+
+    // Used to assign IDs to new programs
+    std::atomic<int> programCounter_{ 0 };
+
+    // Number of programs that arrived and haven't exited yet, running, ready or blocked
+    std::atomic<int> activePrograms_{ 0 };
+
+    // Programs get their ID when they first run rather than when they arrive, if the
+    // scheduling policy asks for it
+    bool idsOnFirstRun_ = false;
 
 
     /***** Simulator config data *****/
@@ -102,26 +399,66 @@ private:
     std::string metaDataFilePath_;
     std::string schedulingCode_;
     int quantum_;
-    int processorCycleTime_;
+    int processorCycleTime_; // cycle times are all in usec, whatever unit the config uses
     int monitorDisplayTime_;
     int hardDriveCycleTime_;
     int printerCycleTime_;
     int keyboardCycleTime_;
+    CycleTimes cycleTimes_; // cycle times above, looked up by operation
     enum LogLocation
     { 
-        SCREEN, FILE, BOTH 
+        SCREEN, FILE, BOTH, BINARY, CHROME_TRACE, NONE
     };
     LogLocation logLocation_;
     std::string logFilePath_;
 
+    // optional settings, these may follow the log file path
+    enum ClockMode
+    {
+        REAL_TIME, VIRTUAL_TIME
+    };
+    ClockMode clockMode_ = REAL_TIME;
+    Logger::Overflow logOverflow_ = Logger::BLOCK;
+    std::size_t logBufferSize_ = 1 << 16;
+    std::string metricsFilePath_; // metrics are only collected if this is set
+    MetricsCollector::Format metricsFormat_ = MetricsCollector::JSON;
+    double speed_ = 1.0; // real-time mode: simulated time that passes per unit of host time
+    std::chrono::microseconds spinThreshold_{ 100 }; // real-time mode: host time spun rather than slept
+    bool hostStatistics_ = false; // measure host overhead and print it with the statistics
+    int deviceChannels_[DEVICE_COUNT] = {}; // operations a device serves at once, 0 for no limit
+    DeviceChannels::Discipline deviceQueues_[DEVICE_COUNT] = {}; // order a device serves waiting requests in
+    int diskCylinders_ = 0; // the hard drive's disk model is only used if this is set
+    int diskBlocksPerCylinder_ = 1;
+    long long diskTrackSeek_ = 1000; // usec
+    long long diskFullSeek_ = 10000; // usec
+    int diskRpm_ = 7200;
+    DiskModel disk_; // built from the settings above
+    std::size_t admissionLookAhead_ = 0; // programs read ahead of their arrival, 0 reads all up front
+    int cpuCount_ = 1;
+    long long syncWindow_ = 0; // usec of simulated time between core barriers, 0 for one quantum
+    SchedulerSettings schedulerSettings_; // passed to the scheduling policy of every core
+
 
     /***** Other simulator variables *****/
 
-    // Time variable to keep track of the beginning of the simulation
-    std::chrono::time_point<std::chrono::system_clock> start_;
+    // Time variable to keep track of the beginning of the simulation. Monotonic, so
+    // adjustments to the system clock don't move the simulation
+    std::chrono::steady_clock::time_point start_;
+
+    // Fires I/O completions in real-time mode, a single thread services every pending I/O
+    std::unique_ptr<TimerWheel> ioTimers_;
 
     // File output object used by print() if log_location_ is set to FILE or BOTH
     std::ofstream fout_;
+
+    // Writes the log on its own thread, every thread that logs has its own producer ring:
+    // one per core, numbered like the cores, and one for the I/O wheel after them
+    std::unique_ptr<Logger> logger_;
+
+    // Collects per-process and system metrics while the run lasts, if a metrics file is set
+    std::unique_ptr<MetricsCollector> metrics_;
+
+    Summary summary_;
 };
 
 #endif // SIMULATOR_H
\ No newline at end of file
@@ -0,0 +1,404 @@
+#include "sweep.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    // Text before the ':' of a "Name: value" line, npos position if there is none
+    std::string setting_name( const std::string& line, std::size_t& colonLocation )
+    {
+        colonLocation = line.find(':');
+        if( colonLocation == std::string::npos )
+        {
+            return "";
+        }
+        return line.substr(0, colonLocation);
+    }
+
+    // Same as the config file, values are trimmed of spaces and a trailing \r
+    std::string trim( const std::string& text )
+    {
+        std::size_t begin = text.find_first_not_of(" \t");
+        if( begin == std::string::npos )
+        {
+            return "";
+        }
+        return text.substr( begin, text.find_last_not_of(" \t\r") + 1 - begin );
+    }
+}
+
+/* Constructor for the Sweep class
+* @param filePath = sweep file
+* @except Throws exception if a file wasn't found or a file format isn't correct
+*/
+Sweep::Sweep( const std::string& filePath )
+{
+    try
+    {
+        std::ifstream fin( filePath, std::ifstream::in );
+        if(!fin)
+        {
+            throw std::runtime_error( "Error: Unable to open file " + filePath + "\n" );
+        }
+
+        std::string line;
+        std::getline(fin, line, '\n');
+        if( trim( line ) != "Start Simulator Sweep File" )
+        {
+            throw std::runtime_error( "Error: Incorrect sweep file format\n" );
+        }
+
+        std::string basePath;
+        while( std::getline(fin, line, '\n') && line.compare(0, 3, "End") != 0 )
+        {
+            if( trim( line ).empty() )
+            {
+                continue;
+            }
+
+            std::size_t colonLocation;
+            std::string name = setting_name( line, colonLocation );
+            if( colonLocation == std::string::npos )
+            {
+                throw std::runtime_error( "Error: Incorrect sweep file format\n" );
+            }
+            std::string value = trim( line.substr(colonLocation + 1) );
+
+            if( name == "Base Configuration" )
+            {
+                basePath = value;
+                continue;
+            }
+
+            // these have to stay the same for every run
+            if( name == "Version/Phase" || name == "File Path" || name == "Log" || name == "Log File Path" ||
+                name == "Metrics File Path" )
+            {
+                throw std::runtime_error( "Error: " + name + " can't be swept\n" );
+            }
+            for( const Parameter &parameter : parameters_ )
+            {
+                if( parameter.name == name )
+                {
+                    throw std::runtime_error( "Error: " + name + " is swept twice\n" );
+                }
+            }
+
+            Parameter parameter;
+            parameter.name = name;
+            parse_values( value, parameter );
+            combinations_ *= parameter.values.size();
+            parameters_.push_back( parameter );
+        }
+        if( line.compare(0, 3, "End") != 0 || basePath.empty() )
+        {
+            throw std::runtime_error( "Error: Incorrect sweep file format\n" );
+        }
+
+        // the base configuration is kept line by line, runs only swap out values
+        std::ifstream base( basePath, std::ifstream::in );
+        if(!base)
+        {
+            throw std::runtime_error( "Error: Unable to open file " + basePath + "\n" );
+        }
+        while( std::getline(base, line, '\n') )
+        {
+            std::size_t colonLocation;
+            if( setting_name( line, colonLocation ) == "File Path" )
+            {
+                metaDataFilePath_ = trim( line.substr(colonLocation + 1) );
+            }
+            base_.push_back( line );
+        }
+    }
+    catch( const std::runtime_error& e )
+    {
+        std::cerr << e.what();
+        throw;
+    }
+}
+
+/* Parse a comma separated list of values
+* @param text = values as written in the sweep file
+* @param parameter = receives the values
+* @except Throws exception if the list is empty or a range is malformed
+*/
+void Sweep::parse_values( const std::string& text, Parameter& parameter )
+{
+    std::stringstream list( text );
+    std::string item;
+    while( std::getline(list, item, ',') )
+    {
+        item = trim( item );
+        std::size_t dots = item.find("..");
+        if( dots == std::string::npos )
+        {
+            if( !item.empty() )
+            {
+                parameter.values.push_back( item );
+            }
+            continue;
+        }
+
+        // from..to, optionally followed by "by step"
+        int from, to, step = 1;
+        std::string rest = item.substr(dots + 2);
+        std::size_t by = rest.find("by");
+        try
+        {
+            from = std::stoi( item.substr(0, dots) );
+            to = std::stoi( rest.substr(0, by) );
+            if( by != std::string::npos )
+            {
+                step = std::stoi( rest.substr(by + 2) );
+            }
+        }
+        catch( const std::logic_error& )
+        {
+            throw std::runtime_error( "Error: Incorrect range " + item + " for " + parameter.name + "\n" );
+        }
+        if( step <= 0 || from > to )
+        {
+            throw std::runtime_error( "Error: Incorrect range " + item + " for " + parameter.name + "\n" );
+        }
+        for( int value = from; value <= to; value += step )
+        {
+            parameter.values.push_back( std::to_string( value ) );
+        }
+    }
+
+    if( parameter.values.empty() )
+    {
+        throw std::runtime_error( "Error: No values given for " + parameter.name + "\n" );
+    }
+}
+
+/* Combination count getter
+*/
+std::size_t Sweep::combinations() const
+{
+    return combinations_;
+}
+
+/* Value of a parameter in a combination. The last parameter changes fastest
+* @param combination = index of the combination
+* @param parameter = index of the parameter
+* @return value as it goes into the configuration
+*/
+const std::string& Sweep::value( const std::size_t combination, const std::size_t parameter ) const
+{
+    std::size_t stride = 1;
+    for( std::size_t i = parameter + 1; i < parameters_.size(); i++ )
+    {
+        stride *= parameters_[i].values.size();
+    }
+    const std::vector<std::string> &values = parameters_[parameter].values;
+    return values[ ( combination / stride ) % values.size() ];
+}
+
+/* Build the configuration of a combination from the base configuration
+* Swept settings get their value, ones missing from the base are added before its end.
+* Runs never write to the screen, and each one that logs to a file gets its own file
+* @param combination = index of the combination
+* @return contents of the configuration file
+*/
+std::string Sweep::configuration( const std::size_t combination ) const
+{
+    std::vector<bool> used( parameters_.size(), false );
+    std::string out;
+    for( const std::string &line : base_ )
+    {
+        std::size_t colonLocation;
+        std::string name = setting_name( line, colonLocation );
+        std::string value = colonLocation == std::string::npos ? "" : trim( line.substr(colonLocation + 1) );
+
+        if( line.compare(0, 3, "End") == 0 )
+        {
+            for( std::size_t i = 0; i < parameters_.size(); i++ )
+            {
+                if( !used[i] )
+                {
+                    out += parameters_[i].name + ": " + this->value( combination, i ) + "\n";
+                }
+            }
+        }
+        else if( name == "Log" )
+        {
+            if( value == "Log to Screen" )
+            {
+                value = "Log to None";
+            }
+            else if( value == "Log to Both" )
+            {
+                value = "Log to File";
+            }
+            out += name + ": " + value + "\n";
+            continue;
+        }
+        else if( name == "Log File Path" || name == "Metrics File Path" )
+        {
+            std::size_t extension = value.find_last_of('.');
+            std::string suffix = "-" + std::to_string( combination + 1 );
+            std::size_t directory = value.find_last_of('/');
+            if( extension == std::string::npos || ( directory != std::string::npos && directory > extension ) )
+            {
+                value += suffix;
+            }
+            else
+            {
+                value.insert( extension, suffix );
+            }
+            out += name + ": " + value + "\n";
+            continue;
+        }
+
+        bool swept = false;
+        for( std::size_t i = 0; i < parameters_.size() && colonLocation != std::string::npos; i++ )
+        {
+            if( parameters_[i].name == name )
+            {
+                out += name + ": " + this->value( combination, i ) + "\n";
+                used[i] = swept = true;
+            }
+        }
+        if( !swept )
+        {
+            out += line + "\n";
+        }
+    }
+    return out;
+}
+
+/* Run one combination on the calling thread
+* @param combination = index of the combination
+* @param workload = programs shared by every run
+* @param failed = set if the run couldn't be completed
+* @return summary table of the run
+*/
+std::string Sweep::run_combination( const std::size_t combination,
+    const std::shared_ptr<const Workload>& workload, bool& failed ) const
+{
+    std::string out = "Run " + std::to_string( combination + 1 ) + " of " + 
+        std::to_string( combinations_ ) + "\n";
+
+    std::size_t width = 22;
+    for( const Parameter &parameter : parameters_ )
+    {
+        width = std::max( width, parameter.name.size() + 2 );
+    }
+    auto row = [&out, width]( const std::string& name, const std::string& value ){
+        out += "  " + name + std::string( width - name.size(), ' ' ) + value + "\n";
+    };
+    for( std::size_t i = 0; i < parameters_.size(); i++ )
+    {
+        row( parameters_[i].name, value( combination, i ) );
+    }
+
+    const auto hostStart = std::chrono::steady_clock::now();
+    Simulator::Summary summary;
+    try
+    {
+        std::istringstream config( configuration( combination ) );
+        Simulator simulator( config, workload );
+        simulator.run();
+        summary = simulator.summary();
+    }
+    catch( const std::exception& )
+    {
+        // the simulator has already reported the error
+        failed = true;
+        row( "Result", "failed" );
+        return out;
+    }
+    const double hostTime = std::chrono::duration<double>( 
+        std::chrono::steady_clock::now() - hostStart ).count();
+
+    char buffer[64];
+    row( "Processes", std::to_string( summary.programs ) );
+    std::snprintf( buffer, sizeof(buffer), "%.6f", 
+        std::chrono::duration<double>( summary.elapsed ).count() );
+    row( "Elapsed time (sec)", buffer );
+    row( "Dispatches", std::to_string( summary.dispatches ) );
+    std::snprintf( buffer, sizeof(buffer), "%.1f%%", summary.elapsed.count() > 0 ?
+        100.0 * summary.busyTime.count() / ( summary.elapsed.count() * summary.cpus ) : 0.0 );
+    row( "CPU utilization", buffer );
+    if( summary.deadlineJobs > 0 )
+    {
+        std::snprintf( buffer, sizeof(buffer), "%llu of %llu", summary.deadlineMisses, summary.deadlineJobs );
+        row( "Deadlines missed", buffer );
+        std::snprintf( buffer, sizeof(buffer), "%.6f",
+            std::chrono::duration<double>( summary.maxTardiness ).count() );
+        row( "Max tardiness (sec)", buffer );
+    }
+    std::snprintf( buffer, sizeof(buffer), "%.3f", hostTime );
+    row( "Host time (sec)", buffer );
+    return out;
+}
+
+/* Run every combination on as many threads as the host has cores
+* Tables are written in combination order, each as soon as the ones before it are done
+* @param out = stream the summary tables are written to
+* @return number of failed runs
+* @except Throws exception if the meta-data file can't be read
+*/
+int Sweep::run( std::ostream& out )
+{
+    std::shared_ptr<const Workload> workload;
+    try
+    {
+        workload.reset( new Workload( metaDataFilePath_ ) );
+    }
+    catch( const std::runtime_error& e )
+    {
+        std::cerr << e.what();
+        throw;
+    }
+
+    std::vector<std::string> reports( combinations_ );
+    std::vector<bool> done( combinations_, false );
+    std::size_t written = 0;
+    int failures = 0;
+    std::mutex mutex;
+    std::atomic<std::size_t> next{ 0 };
+
+    auto worker = [&](){
+        std::size_t combination;
+        while( ( combination = next++ ) < combinations_ )
+        {
+            bool failed = false;
+            std::string report = run_combination( combination, workload, failed );
+
+            std::lock_guard<std::mutex> lock( mutex );
+            reports[combination].swap( report );
+            done[combination] = true;
+            failures += failed ? 1 : 0;
+            while( written < combinations_ && done[written] )
+            {
+                out << reports[written] << std::endl;
+                reports[written].clear();
+                written++;
+            }
+        }
+    };
+
+    std::size_t threadCount = std::max( 1u, std::thread::hardware_concurrency() );
+    threadCount = std::min( threadCount, combinations_ );
+    std::vector<std::thread> threads;
+    for( std::size_t i = 0; i < threadCount; i++ )
+    {
+        threads.emplace_back( worker );
+    }
+    for( std::thread &thread : threads )
+    {
+        thread.join();
+    }
+    return failures;
+}
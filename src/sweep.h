@@ -0,0 +1,70 @@
+/*
+* Filename: sweep.h
+* Specifications for the Sweep object, which runs a configuration once for every
+* combination of a set of setting values.
+*
+* A sweep file names a base configuration and the settings to vary, one per line:
+*   Start Simulator Sweep File
+*   Base Configuration: config.cnf
+*   CPU Scheduling Code: RR, FIFO-P, SRTF-P
+*   Quantum Time (cycles): 2..6
+*   Processor cycle time (msec): 10..50 by 10
+*   End Simulator Sweep File
+* Settings are named as in the configuration file. Values are a comma separated list, in
+* which an integer range "from..to" or "from..to by step" can stand in for single values.
+*/
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "simulator.h"
+#include "workload.h"
+
+/* Parameter sweep. The meta-data file is read once and shared by every run, and the
+* runs are spread over a pool of host threads */
+class Sweep
+{
+public:
+    // Reads the sweep file and its base configuration
+    explicit Sweep( const std::string& filePath );
+
+    // Runs every combination, writing a summary table for each one in order.
+    // Returns the number of runs that failed
+    int run( std::ostream& out );
+
+    // Number of runs in the sweep
+    std::size_t combinations() const;
+
+private:
+    struct Parameter
+    {
+        std::string name;
+        std::vector<std::string> values;
+    };
+
+    // Reads the values of a setting, expanding ranges
+    void parse_values( const std::string& text, Parameter& parameter );
+
+    // Value a parameter takes in a combination, combinations count from 0
+    const std::string& value( const std::size_t combination, const std::size_t parameter ) const;
+
+    // Contents of the configuration file for a combination
+    std::string configuration( const std::size_t combination ) const;
+
+    // Runs a single combination and formats its summary table
+    std::string run_combination( const std::size_t combination,
+        const std::shared_ptr<const Workload>& workload, bool& failed ) const;
+
+    std::vector<std::string> base_; // lines of the base configuration
+    std::string metaDataFilePath_;
+    std::vector<Parameter> parameters_;
+    std::size_t combinations_ = 1;
+};
+
+#endif // SWEEP_H
@@ -0,0 +1,226 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+
+/* Constructor for the TimerWheel class, starts the servicing thread
+* @param resolution = length of a single tick, timers of the same tick share a bucket
+*/
+TimerWheel::TimerWheel( const std::chrono::microseconds resolution )
+    : start_( Clock::now() ), resolution_( resolution )
+{
+    thread_ = std::thread( [this](){ run(); } );
+}
+
+TimerWheel::~TimerWheel()
+{
+    stop();
+}
+
+/* Schedule a callback
+* @param deadline = point in time after which the callback runs
+* @param callback = function to run on the wheel's thread
+*/
+void TimerWheel::schedule( const Clock::time_point deadline, Callback callback )
+{
+    auto sinceStart = std::chrono::duration_cast<std::chrono::microseconds>( deadline - start_ );
+    Timer timer;
+    timer.deadline = deadline;
+    timer.expiry = sinceStart.count() > 0 ? sinceStart.count() / resolution_.count() : 0;
+    timer.callback = std::move( callback );
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        timer.sequence = sequence_++;
+        insert( std::move(timer) );
+        pending_++;
+    }
+
+    // the thread may be asleep until a later deadline
+    wakeup_.notify_one();
+}
+
+/* Stop the servicing thread and wait for it to finish
+*/
+void TimerWheel::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        running_ = false;
+    }
+    wakeup_.notify_one();
+    if( thread_.joinable() )
+    {
+        thread_.join();
+    }
+}
+
+/* Servicing thread. While timers are pending it sleeps until the earliest deadline in
+* the due queue, or until the wheel has timers to move to it, whichever comes first.
+* Callbacks run without the lock held so they may schedule new timers themselves.
+*/
+void TimerWheel::run()
+{
+    std::vector<Timer> expired;
+    std::unique_lock<std::mutex> lock( mutex_ );
+    while( running_ )
+    {
+        if( pending_ == 0 )
+        {
+            // nothing can expire until a timer is scheduled
+            wakeup_.wait( lock );
+            continue;
+        }
+
+        const Clock::time_point now = Clock::now();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>( now - start_ );
+        const std::uint64_t nowTick = elapsed.count() > 0 ? elapsed.count() / resolution_.count() : 0;
+
+        // ticks that have nothing to move are skipped rather than processed one by one
+        while( currentTick_ < nowTick )
+        {
+            const std::uint64_t next = pending_ == due_.size() ? nowTick + 1 : next_tick();
+            if( next > nowTick )
+            {
+                currentTick_ = nowTick;
+                break;
+            }
+            currentTick_ = next - 1;
+            tick();
+        }
+
+        while( !due_.empty() && due_.top().deadline <= now )
+        {
+            expired.push_back( due_.top() );
+            due_.pop();
+        }
+
+        if( !expired.empty() )
+        {
+            pending_ -= expired.size();
+            lock.unlock();
+            for( Timer &timer : expired )
+            {
+                timer.callback();
+            }
+            expired.clear();
+            lock.lock();
+            continue;
+        }
+
+        Clock::time_point wake = Clock::time_point::max();
+        if( pending_ > due_.size() )
+        {
+            wake = start_ + resolution_ * static_cast<long long>( next_tick() );
+        }
+        if( !due_.empty() )
+        {
+            wake = std::min( wake, due_.top().deadline );
+        }
+        wakeup_.wait_until( lock, wake );
+    }
+}
+
+/* Insert timer into the wheel, the lock must be held
+* Timers whose tick already came up go straight to the due queue
+* @param timer to insert
+*/
+void TimerWheel::insert( Timer timer )
+{
+    if( timer.expiry <= currentTick_ )
+    {
+        due_.push( std::move(timer) );
+        return;
+    }
+
+    // find the lowest level whose range covers the distance to the expiry
+    std::uint64_t delta = timer.expiry - currentTick_;
+    int level = 0;
+    while( level < LEVELS - 1 && delta >= ( std::uint64_t(1) << ( SLOT_BITS * (level + 1) ) ) )
+    {
+        level++;
+    }
+
+    // timers beyond the range of the wheel wait in the farthest slot and get re-inserted
+    std::uint64_t slotTick = timer.expiry;
+    std::uint64_t range = std::uint64_t(1) << ( SLOT_BITS * LEVELS );
+    if( delta >= range )
+    {
+        slotTick = currentTick_ + range - 1;
+    }
+
+    int slot = ( slotTick >> ( SLOT_BITS * level ) ) & ( SLOTS - 1 );
+    slots_[level][slot].push_back( std::move(timer) );
+}
+
+/* Advance the wheel a single tick, the lock must be held
+* Higher levels are cascaded first so their timers can land in the slots that are
+* processed right after them
+*/
+void TimerWheel::tick()
+{
+    currentTick_++;
+
+    for( int level = LEVELS - 1; level > 0; level-- )
+    {
+        std::uint64_t lowerBits = ( std::uint64_t(1) << ( SLOT_BITS * level ) ) - 1;
+        if( ( currentTick_ & lowerBits ) != 0 )
+        {
+            continue;
+        }
+
+        int slot = ( currentTick_ >> ( SLOT_BITS * level ) ) & ( SLOTS - 1 );
+        std::vector<Timer> cascading;
+        cascading.swap( slots_[level][slot] );
+        for( Timer &timer : cascading )
+        {
+            insert( std::move(timer) );
+        }
+    }
+
+    std::vector<Timer> &due = slots_[0][ currentTick_ & ( SLOTS - 1 ) ];
+    for( Timer &timer : due )
+    {
+        due_.push( std::move(timer) );
+    }
+    due.clear();
+}
+
+/* Find the next tick the wheel has to process, the lock must be held. The lowest level
+* only holds timers of the next 63 ticks, beyond those only cascades can move timers, and
+* each level cascades at multiples of its slot width. So the search goes a tick at a time
+* at first, then a slot of each higher level at a time, a few hundred steps at most
+* @return tick number
+*/
+std::uint64_t TimerWheel::next_tick() const
+{
+    std::uint64_t tick = currentTick_ + 1;
+    while( true )
+    {
+        const std::uint64_t delta = tick - currentTick_;
+        if( delta < SLOTS && !slots_[0][ tick & ( SLOTS - 1 ) ].empty() )
+        {
+            return tick;
+        }
+        for( int level = 1; level < LEVELS; level++ )
+        {
+            std::uint64_t lowerBits = ( std::uint64_t(1) << ( SLOT_BITS * level ) ) - 1;
+            int slot = ( tick >> ( SLOT_BITS * level ) ) & ( SLOTS - 1 );
+            if( ( tick & lowerBits ) == 0 && !slots_[level][slot].empty() )
+            {
+                return tick;
+            }
+        }
+
+        // timers beyond the range of the wheel are re-inserted from its farthest slot
+        if( delta >= ( std::uint64_t(1) << ( SLOT_BITS * LEVELS ) ) )
+        {
+            return tick;
+        }
+        int level = 0;
+        while( level < LEVELS - 1 && delta >= ( std::uint64_t(1) << ( SLOT_BITS * (level + 1) ) ) )
+        {
+            level++;
+        }
+        const std::uint64_t step = std::uint64_t(1) << ( SLOT_BITS * level );
+        tick = ( tick / step + 1 ) * step;
+    }
+}
@@ -0,0 +1,100 @@
+/*
+* Filename: timer_wheel.h
+* Specifications for the TimerWheel object. Holds pending timers and fires them
+* from a single background thread.
+*/
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/* Hierarchical timer wheel. Each level has 64 slots and covers 64 times the range
+* of the level below it; timers cascade down a level whenever the level below wraps.
+* Inserting a timer is O(1) no matter how many are pending. The wheel only sorts timers
+* into buckets of a tick: once a timer's tick comes up it moves to a short queue ordered
+* by deadline, and the thread sleeps until the earliest deadline, so timers fire on time
+* rather than on a tick. */
+class TimerWheel
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void()>;
+
+    // Starts the servicing thread, with buckets of resolution
+    explicit TimerWheel( const std::chrono::microseconds resolution = std::chrono::milliseconds(1) );
+    ~TimerWheel();
+
+    TimerWheel( const TimerWheel& ) = delete;
+    TimerWheel& operator=( const TimerWheel& ) = delete;
+
+    // Runs callback on the wheel's thread once deadline has passed. Timers with the
+    // same deadline fire in the order they were scheduled
+    void schedule( const Clock::time_point deadline, Callback callback );
+
+    // Stops the servicing thread, timers that are still pending never fire
+    void stop();
+
+private:
+    struct Timer
+    {
+        Clock::time_point deadline;
+        std::uint64_t expiry; // tick the deadline falls in
+        std::uint64_t sequence; // order of scheduling, breaks ties between deadlines
+        Callback callback;
+    };
+
+    // Orders the due queue, earliest deadline on top
+    struct Later
+    {
+        bool operator()( const Timer& left, const Timer& right ) const
+        {
+            if( left.deadline != right.deadline )
+            {
+                return left.deadline > right.deadline;
+            }
+            return left.sequence > right.sequence;
+        }
+    };
+
+    // Thread body, advances the wheel as wall clock time passes
+    void run();
+
+    // Queues a timer whose tick came up, or places it into the slot matching its
+    // distance from the current tick
+    void insert( Timer timer );
+
+    // Advances the wheel by one tick, moving the timers of the new tick to the due queue
+    void tick();
+
+    // First tick after the current one that has timers to move: one whose slot isn't
+    // empty, or one where a higher level cascades a slot that isn't
+    std::uint64_t next_tick() const;
+
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+
+    std::vector<Timer> slots_[LEVELS][SLOTS];
+    std::priority_queue<Timer, std::vector<Timer>, Later> due_; // timers whose tick came up
+    std::uint64_t currentTick_ = 0; // last tick that was processed
+    std::uint64_t sequence_ = 0;
+    std::size_t pending_ = 0; // in the wheel and in due_
+
+    const Clock::time_point start_;
+    const std::chrono::microseconds resolution_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    bool running_ = true;
+    std::thread thread_;
+};
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,151 @@
+#include "trace.h"
+
+#include <stdexcept>
+
+namespace
+{
+    const char MAGIC[] = "SIMTRACE";
+    const int MAGIC_LENGTH = 8;
+    const unsigned long long VERSION = 3;
+
+    void put_varint( unsigned long long value, std::string& out )
+    {
+        while( value >= 0x80 )
+        {
+            out += static_cast<char>( (value & 0x7f) | 0x80 );
+            value >>= 7;
+        }
+        out += static_cast<char>( value );
+    }
+
+    // zigzag keeps small negative deltas small
+    void put_signed( const long long value, std::string& out )
+    {
+        put_varint( ( static_cast<unsigned long long>(value) << 1 ) ^ 
+            static_cast<unsigned long long>( value >> 63 ), out );
+    }
+
+    // throws if the stream ends inside the varint
+    void get_varint( std::istream& in, unsigned long long& value )
+    {
+        value = 0;
+        for( int shift = 0; shift < 64; shift += 7 )
+        {
+            int byte = in.get();
+            if( byte == std::char_traits<char>::eof() )
+            {
+                throw std::runtime_error( "Error: Trace file is truncated\n" );
+            }
+            value |= static_cast<unsigned long long>( byte & 0x7f ) << shift;
+            if( (byte & 0x80) == 0 )
+            {
+                return;
+            }
+        }
+        throw std::runtime_error( "Error: Trace file is corrupted\n" );
+    }
+
+    long long get_signed( std::istream& in )
+    {
+        unsigned long long value;
+        get_varint( in, value );
+        return static_cast<long long>( value >> 1 ) ^ -static_cast<long long>( value & 1 );
+    }
+
+    unsigned char get_byte( std::istream& in )
+    {
+        int byte = in.get();
+        if( byte == std::char_traits<char>::eof() )
+        {
+            throw std::runtime_error( "Error: Trace file is truncated\n" );
+        }
+        return static_cast<unsigned char>( byte );
+    }
+}
+
+/* Write the magic and the format version
+* @param out = buffer the header is appended to
+*/
+void TraceEncoder::header( std::string& out )
+{
+    out.append( MAGIC, MAGIC_LENGTH );
+    put_varint( VERSION, out );
+}
+
+/* Encode a single record
+* @param record to encode
+* @param out = buffer the entry is appended to
+*/
+void TraceEncoder::encode( const LogRecord& record, std::string& out )
+{
+    out += static_cast<char>( record.event );
+    put_signed( record.time - lastTime_, out );
+    put_signed( record.wallTime - lastWallTime_, out );
+    put_varint( static_cast<unsigned int>( record.processID ), out );
+    out += static_cast<char>( record.device | ( record.input ? 0x80 : 0 ) );
+    out += static_cast<char>( record.cpu );
+    put_signed( record.value, out );
+    lastTime_ = record.time;
+    lastWallTime_ = record.wallTime;
+}
+
+/* Constructor for the TraceDecoder class, checks the header
+* @param in = stream positioned at the start of a trace
+* @except Throws exception if the magic or the version don't match
+*/
+TraceDecoder::TraceDecoder( std::istream& in ) : in_( in )
+{
+    char magic[MAGIC_LENGTH];
+    in_.read( magic, MAGIC_LENGTH );
+    if( in_.gcount() != MAGIC_LENGTH || std::string( magic, MAGIC_LENGTH ) != MAGIC )
+    {
+        throw std::runtime_error( "Error: Not a simulator trace file\n" );
+    }
+
+    unsigned long long version;
+    get_varint( in_, version );
+    if( version != VERSION )
+    {
+        throw std::runtime_error( "Error: Unsupported trace version " + 
+            std::to_string( version ) + "\n" );
+    }
+}
+
+/* Decode the next record
+* @param record = receives the decoded record
+* @return false once the whole trace was read
+* @except Throws exception if the trace ends in the middle of a record
+*/
+bool TraceDecoder::next( LogRecord& record )
+{
+    int event = in_.get();
+    if( event == std::char_traits<char>::eof() )
+    {
+        return false;
+    }
+    if( event >= EVENT_COUNT )
+    {
+        throw std::runtime_error( "Error: Trace file is corrupted\n" );
+    }
+
+    record.event = static_cast<EventCode>( event );
+    lastTime_ += get_signed( in_ );
+    lastWallTime_ += get_signed( in_ );
+    record.time = lastTime_;
+    record.wallTime = lastWallTime_;
+
+    unsigned long long processID;
+    get_varint( in_, processID );
+    record.processID = static_cast<int>( processID );
+
+    unsigned char device = get_byte( in_ );
+    if( (device & 0x7f) >= DEVICE_COUNT )
+    {
+        throw std::runtime_error( "Error: Trace file is corrupted\n" );
+    }
+    record.device = static_cast<Device>( device & 0x7f );
+    record.input = ( device & 0x80 ) != 0;
+    record.cpu = get_byte( in_ );
+    record.value = static_cast<int>( get_signed( in_ ) );
+    return true;
+}
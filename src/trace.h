@@ -0,0 +1,56 @@
+/*
+* Filename: trace.h
+* Specifications for the binary trace format written by "Log to Binary".
+*
+* A trace starts with the 8 byte magic "SIMTRACE" and a varint format version,
+* followed by one entry per LogRecord:
+*   event        1 byte
+*   time         zigzag varint, microseconds since the previous entry's time
+*   wallTime     zigzag varint, microseconds since the previous entry's wallTime
+*   processID    varint
+*   device       1 byte, high bit set for input
+*   cpu          1 byte, 0 when only a single CPU was simulated
+*   value        zigzag varint
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <istream>
+#include <string>
+
+#include "log_record.h"
+
+/* Turns LogRecords into the binary trace format. Times are delta encoded, so one
+* encoder has to see every record of a trace in order */
+class TraceEncoder
+{
+public:
+    // Appends the trace header to out
+    void header( std::string& out );
+
+    // Appends the encoded record to out
+    void encode( const LogRecord& record, std::string& out );
+
+private:
+    long long lastTime_ = 0;
+    long long lastWallTime_ = 0;
+};
+
+/* Reads LogRecords back from a binary trace */
+class TraceDecoder
+{
+public:
+    // Reads the header, throws if the stream isn't a trace of a supported version
+    explicit TraceDecoder( std::istream& in );
+
+    // Reads the next record, false at the end of the trace
+    bool next( LogRecord& record );
+
+private:
+    std::istream& in_;
+    long long lastTime_ = 0;
+    long long lastWallTime_ = 0;
+};
+
+#endif // TRACE_H
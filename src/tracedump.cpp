@@ -0,0 +1,112 @@
+/* Tracedump
+*
+* Filename: tracedump.cpp
+*
+* Description: Converts a binary trace written with "Log: Log to Binary" back into
+* the simulator's text log, into CSV for analysis, or into Trace Event Format JSON
+* that chrome://tracing and Perfetto can open.
+*
+* Compilation: Use the provided makefile.
+*   $ make tracedump
+*
+* Usage: The trace file is required, output goes to stdout.
+*   $ ./tracedump trace_file [--csv | --chrome]
+*/
+
+/* Dependencies */
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "chrome_trace.h"
+#include "log_record.h"
+#include "trace.h"
+
+/* Main */
+int main(const int argc, char const *argv[])
+{
+    // Check to see if a trace file was provided
+    bool csv = argc == 3 && std::string( argv[2] ) == "--csv";
+    bool chrome = argc == 3 && std::string( argv[2] ) == "--chrome";
+    if( argc != 2 && !csv && !chrome )
+    {
+        std::cerr
+        << "Error: Incorrect command line arguments" << std::endl
+        << "Example usage: " << argv[0] << " trace_file [--csv | --chrome]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream fin( argv[1], std::ifstream::binary );
+    if( !fin )
+    {
+        std::cerr << "Error: Unable to open file " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        TraceDecoder decoder( fin );
+        LogRecord record;
+        std::string out;
+        ChromeTraceWriter chromeWriter;
+        if( csv )
+        {
+            out += "time_us,wall_time_us,cpu,event,pid,device,access,value\n";
+        }
+        else if( chrome )
+        {
+            chromeWriter.header( out );
+        }
+
+        while( decoder.next( record ) )
+        {
+            if( csv )
+            {
+                out.append( std::to_string( record.time ) ).append( "," )
+                    .append( std::to_string( record.wallTime ) ).append( "," )
+                    .append( std::to_string( record.cpu ) ).append( "," )
+                    .append( event_name( record.event ) ).append( "," )
+                    .append( std::to_string( record.processID ) ).append( "," );
+                if( record.device != NO_DEVICE )
+                {
+                    out.append( device_name( record.device ) ).append( "," )
+                        .append( record.input ? "input" : "output" );
+                }
+                else
+                {
+                    out += ",";
+                }
+                out.append( "," ).append( std::to_string( record.value ) );
+                out += '\n';
+            }
+            else if( chrome )
+            {
+                chromeWriter.encode( record, out );
+            }
+            else
+            {
+                format_record( record, out );
+            }
+
+            if( out.size() >= (1 << 16) )
+            {
+                std::cout << out;
+                out.clear();
+            }
+        }
+        if( chrome )
+        {
+            chromeWriter.footer( out );
+        }
+        std::cout << out;
+    }
+    catch( const std::runtime_error& e )
+    {
+        std::cerr << e.what();
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
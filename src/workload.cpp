@@ -0,0 +1,55 @@
+#include "workload.h"
+
+#include "meta_data_reader.h"
+#include "workload_snapshot.h"
+
+/* Constructor for the Workload class, reads every program
+* A compiled workload is copied out of its mapping, its cycle times are ignored
+* @param filePath = meta-data file or compiled workload
+* @except Throws exception if the file can't be read or its format isn't correct
+*/
+Workload::Workload( const std::string& filePath )
+{
+    if( is_workload_snapshot( filePath ) )
+    {
+        WorkloadSnapshot snapshot( filePath );
+        const SnapshotHeader &header = snapshot.header();
+        operations_.assign( snapshot.operations(), snapshot.operations() + header.operationCount );
+        programs_.reserve( header.programCount );
+        for( std::uint64_t i = 0; i < header.programCount; i++ )
+        {
+            const SnapshotProgram &program = snapshot.programs()[i];
+            Entry entry;
+            entry.firstOperation = program.firstOperation;
+            entry.operationCount = program.operationCount;
+            entry.attributes = program.attributes;
+            programs_.push_back( entry );
+        }
+        return;
+    }
+
+    MetaDataReader reader( filePath );
+    std::vector<Operation> operations;
+    Entry entry;
+    while( reader.next_program( operations, entry.attributes ) )
+    {
+        entry.firstOperation = operations_.size();
+        entry.operationCount = operations.size();
+        operations_.insert( operations_.end(), operations.begin(), operations.end() );
+        programs_.push_back( entry );
+    }
+}
+
+/* Programs getter, in the order they were read
+*/
+const std::vector<Workload::Entry>& Workload::programs() const
+{
+    return programs_;
+}
+
+/* Operations getter, every program's operations one after the other
+*/
+const Operation* Workload::operations() const
+{
+    return operations_.data();
+}
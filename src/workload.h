@@ -0,0 +1,42 @@
+/*
+* Filename: workload.h
+* Specifications for the Workload object, a whole workload held in memory so several
+* simulations can share it.
+*/
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "operation.h"
+#include "program.h"
+
+/* Every program of a meta-data file or compiled workload, read once and then only read
+* from, so any number of simulations can use it at the same time. Operations only keep
+* their cycle counts, each simulation applies the cycle times of its own config */
+class Workload
+{
+public:
+    // Where a program's operations are in operations()
+    struct Entry
+    {
+        std::size_t firstOperation;
+        std::size_t operationCount;
+        ProgramAttributes attributes;
+    };
+
+    // Reads the whole file, throws if the meta-data is wrong
+    explicit Workload( const std::string& filePath );
+
+    const std::vector<Entry>& programs() const;
+    const Operation* operations() const;
+
+private:
+    std::vector<Entry> programs_;
+    std::vector<Operation> operations_;
+};
+
+#endif // WORKLOAD_H
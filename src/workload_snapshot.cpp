@@ -0,0 +1,134 @@
+#include "workload_snapshot.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    const char MAGIC[8] = "SIMWKLD";
+    const std::uint32_t VERSION = 8;
+}
+
+/* Check a file's magic without reading the rest of it
+* @param filePath = file to check
+* @return true if it is a workload snapshot
+*/
+bool is_workload_snapshot( const std::string& filePath )
+{
+    std::ifstream fin( filePath, std::ifstream::binary );
+    char magic[sizeof(MAGIC)];
+    fin.read( magic, sizeof(magic) );
+    return fin.gcount() == sizeof(magic) && std::memcmp( magic, MAGIC, sizeof(MAGIC) ) == 0;
+}
+
+/* Write a snapshot of programs that haven't been run yet
+* @param filePath = file to write
+* @param header = cycle times the programs were loaded with, the rest is filled in here
+* @param programs = programs to write, in order
+* @except Throws exception if the file can't be written
+*/
+void write_workload_snapshot( const std::string& filePath, SnapshotHeader header,
+    const ProgramTable& programs )
+{
+    std::ofstream fout( filePath, std::ofstream::binary );
+    if( !fout )
+    {
+        throw std::runtime_error( "Error: Unable to open file " + filePath + "\n" );
+    }
+
+    std::memcpy( header.magic, MAGIC, sizeof(MAGIC) );
+    header.version = VERSION;
+    header.operationSize = sizeof(Operation);
+    header.programCount = programs.size();
+    header.operationCount = 0;
+    header.attributesSize = sizeof(ProgramAttributes);
+    for( std::size_t i = 0; i < programs.size(); i++ )
+    {
+        header.operationCount += programs[i].remaining_operations();
+    }
+    fout.write( reinterpret_cast<const char*>( &header ), sizeof(header) );
+
+    SnapshotProgram entry;
+    entry.firstOperation = 0;
+    for( std::size_t i = 0; i < programs.size(); i++ )
+    {
+        const Program &program = programs[i];
+        entry.operationCount = program.remaining_operations();
+        entry.remainingTime = program.remaining_time();
+        entry.attributes = program.attributes;
+        fout.write( reinterpret_cast<const char*>( &entry ), sizeof(entry) );
+        entry.firstOperation += entry.operationCount;
+    }
+
+    for( std::size_t i = 0; i < programs.size(); i++ )
+    {
+        fout.write( reinterpret_cast<const char*>( programs[i].upcoming_operations() ),
+            programs[i].remaining_operations() * sizeof(Operation) );
+    }
+
+    if( !fout )
+    {
+        throw std::runtime_error( "Error: Unable to write file " + filePath + "\n" );
+    }
+}
+
+/* Constructor for the WorkloadSnapshot class
+* Only the header and the program index are checked, operations are never touched
+* @param filePath = snapshot to map
+* @except Throws exception if the file is not a valid snapshot
+*/
+WorkloadSnapshot::WorkloadSnapshot( const std::string& filePath ) : file_( filePath )
+{
+    const std::string error = "Error: Incorrect workload snapshot " + filePath + ": ";
+    if( file_.size() < sizeof(SnapshotHeader) || 
+        std::memcmp( header().magic, MAGIC, sizeof(MAGIC) ) != 0 )
+    {
+        throw std::runtime_error( error + "header is missing\n" );
+    }
+    if( header().version != VERSION || header().operationSize != sizeof(Operation) ||
+        header().attributesSize != sizeof(ProgramAttributes) )
+    {
+        throw std::runtime_error( error + "unsupported version, compile it again\n" );
+    }
+
+    std::uint64_t expectedSize = sizeof(SnapshotHeader) + 
+        header().programCount * sizeof(SnapshotProgram) + 
+        header().operationCount * sizeof(Operation);
+    if( file_.size() != expectedSize )
+    {
+        throw std::runtime_error( error + "file size doesn't match its header\n" );
+    }
+
+    for( std::uint64_t i = 0; i < header().programCount; i++ )
+    {
+        const SnapshotProgram &program = programs()[i];
+        if( program.firstOperation + program.operationCount > header().operationCount ||
+            program.operationCount == 0 )
+        {
+            throw std::runtime_error( error + "program index is corrupted\n" );
+        }
+    }
+}
+
+/* Header getter
+*/
+const SnapshotHeader& WorkloadSnapshot::header() const
+{
+    return *reinterpret_cast<const SnapshotHeader*>( file_.begin() );
+}
+
+/* Program index getter
+*/
+const SnapshotProgram* WorkloadSnapshot::programs() const
+{
+    return reinterpret_cast<const SnapshotProgram*>( file_.begin() + sizeof(SnapshotHeader) );
+}
+
+/* Operations getter
+*/
+const Operation* WorkloadSnapshot::operations() const
+{
+    return reinterpret_cast<const Operation*>( 
+        reinterpret_cast<const char*>( programs() ) + header().programCount * sizeof(SnapshotProgram) );
+}
@@ -0,0 +1,77 @@
+/*
+* Filename: workload_snapshot.h
+* Specifications for precompiled workload files, written by "sim03 --compile".
+*
+* A snapshot is laid out so it can be used straight from a memory mapping:
+*   SnapshotHeader
+*   SnapshotProgram, programCount of them
+*   Operation, operationCount of them, timed by the header's cycle times
+* Records are stored in the host's native layout, so a snapshot is only meant to be
+* read on the kind of machine that wrote it.
+*/
+
+#ifndef WORKLOAD_SNAPSHOT_H
+#define WORKLOAD_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+#include "operation.h"
+#include "program.h"
+#include "program_table.h"
+
+/* Start of every snapshot */
+struct SnapshotHeader
+{
+    char magic[8]; // "SIMWKLD" and a null
+    std::uint32_t version;
+    std::uint32_t operationSize; // sizeof(Operation) of the writer
+    std::uint64_t programCount;
+    std::uint64_t operationCount;
+
+    // cycle times from the config the workload was compiled with, usec
+    std::int32_t processorCycleTime;
+    std::int32_t monitorDisplayTime;
+    std::int32_t hardDriveCycleTime;
+    std::int32_t printerCycleTime;
+    std::int32_t keyboardCycleTime;
+    std::uint32_t attributesSize; // sizeof(ProgramAttributes) of the writer
+};
+static_assert( sizeof(SnapshotHeader) % 8 == 0, "Program index has to stay aligned" );
+
+/* Index entry of a single program */
+struct SnapshotProgram
+{
+    std::uint64_t firstOperation;
+    std::uint64_t operationCount;
+    std::int64_t remainingTime;
+    ProgramAttributes attributes;
+};
+static_assert( sizeof(SnapshotProgram) % 8 == 0, "Operations have to stay aligned" );
+
+// True if the file starts with the snapshot magic
+bool is_workload_snapshot( const std::string& filePath );
+
+// Writes programs to a snapshot, header only needs its cycle times filled in
+void write_workload_snapshot( const std::string& filePath, SnapshotHeader header,
+    const ProgramTable& programs );
+
+/* A mapped, validated snapshot. Programs built from it point straight into the
+* mapping, so it has to outlive them */
+class WorkloadSnapshot
+{
+public:
+    // Maps the file and checks the header and the index, throws if anything is off
+    explicit WorkloadSnapshot( const std::string& filePath );
+
+    const SnapshotHeader& header() const;
+    const SnapshotProgram* programs() const;
+    const Operation* operations() const;
+
+private:
+    MappedFile file_;
+};
+
+#endif // WORKLOAD_SNAPSHOT_H